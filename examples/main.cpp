@@ -71,6 +71,27 @@ int main()
 	}
 	
 	
+	// Native format
+	
+	{
+		// A header whose sizes wrap around 64 bits is rejected by both load paths
+
+		djv::fmt::native::Header header = djv::fmt::native::createHeader<djv::Pixel_rgba_u8>(1, 1);
+		header.width = 1ull << 32;
+		header.height = 1ull << 32;
+		header.stride = header.width * sizeof(djv::Pixel_rgba_u8);
+
+		std::vector<uint8_t> file(djv::fmt::native::pageSize + 64, 0);
+		std::copy_n(reinterpret_cast<const uint8_t*>(&header), sizeof(header), file.data());
+
+		assert(djv::Image_rgba_u8::constructAroundMemory(file.data(), file.size()) == nullptr);
+
+		djv::MemoryIStream stream(file.data(), file.size());
+		djv::Image_rgba_u8 result(stream.getStream(), djv::ImageFormat::Djv);
+		assert(!result.getStatus());
+	}
+	
+	
 	// Blurs
 	
 	{
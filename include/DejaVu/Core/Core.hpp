@@ -16,4 +16,16 @@
 
 #include <DejaVu/Core/templates/Shape.hpp>
 #include <DejaVu/Core/templates/Pixel.hpp>
+#include <DejaVu/Core/templates/Jpeg.hpp>
+#include <DejaVu/Core/templates/Png.hpp>
+#include <DejaVu/Core/templates/Y4m.hpp>
+#include <DejaVu/Core/templates/Native.hpp>
+#include <DejaVu/Core/templates/Resampler.hpp>
+#include <DejaVu/Core/templates/Remap.hpp>
+#include <DejaVu/Core/templates/DrawList.hpp>
+#include <DejaVu/Core/templates/Stream.hpp>
 #include <DejaVu/Core/templates/Image.hpp>
+#include <DejaVu/Core/templates/IntegralImage.hpp>
+#include <DejaVu/Core/templates/IoQueue.hpp>
+#include <DejaVu/Core/templates/SequenceReader.hpp>
+#include <DejaVu/Core/templates/Pyramid.hpp>
@@ -16,7 +16,19 @@
 
 #include <DejaVu/Core/Shape.hpp>
 #include <DejaVu/Core/Pixel.hpp>
+#include <DejaVu/Core/Jpeg.hpp>
+#include <DejaVu/Core/Png.hpp>
+#include <DejaVu/Core/Y4m.hpp>
+#include <DejaVu/Core/Native.hpp>
+#include <DejaVu/Core/Resampler.hpp>
+#include <DejaVu/Core/Remap.hpp>
+#include <DejaVu/Core/DrawList.hpp>
+#include <DejaVu/Core/Stream.hpp>
 #include <DejaVu/Core/Image.hpp>
+#include <DejaVu/Core/IntegralImage.hpp>
+#include <DejaVu/Core/IoQueue.hpp>
+#include <DejaVu/Core/SequenceReader.hpp>
+#include <DejaVu/Core/Pyramid.hpp>
 
 
 #pragma region djvPixelMacros
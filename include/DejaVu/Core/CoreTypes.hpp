@@ -9,9 +9,31 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <array>
+#include <bit>
+#include <condition_variable>
 #include <cstdio>
 #include <deque>
 #include <filesystem>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#define DJV_POSIX
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+	#define DJV_IO_URING
+	#include <linux/io_uring.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+#endif
 
 #include <SciPP/SciPPTypes.hpp>
 #include <Diskon/DiskonTypes.hpp>
@@ -32,9 +54,22 @@ namespace djv
 		&& std::copyable<typename T::Generator>
 	);
 
+	template<typename T> concept CSpanShape = (
+		CShape<T>
+		&& requires {
+			typename T::SpanGenerator;
+		}
+		&& requires (T a, uint64_t width, uint64_t height, int64_t y, int64_t xBegin, int64_t xEnd) {
+			{ a.getSpanGenerator(width, height) } -> std::same_as<typename T::SpanGenerator>;
+			{ a.getSpanGenerator(width, height).getNextSpan(y, xBegin, xEnd) } -> std::same_as<bool>;
+		}
+	);
+
 	class ShapeThickRect;
 	class ShapeCrown;
 	class ShapeLine;
+	class ShapePolygon;
+	class ShapeEllipse;
 	class ShapeFilledRect;
 	class ShapeRect;
 	class ShapeDisc;
@@ -48,8 +83,42 @@ namespace djv
 		template<typename TComponent, uint8_t ComponentCount> static constexpr Pixel<TComponent, ComponentCount> white = std::integral<TComponent> ? std::numeric_limits<TComponent>::max() : 1.0;
 	}
 
+	namespace fmt
+	{
+		class JpegIStream;
+		class PngIStream;
+		class PngOStream;
+		class Y4mIStream;
+	}
+
+	enum class ResamplingFilter;
+
+	namespace _djv
+	{
+		template<CPixel TPixel> class StreamResampler;
+		class ThreadPool;
+	}
+
+	enum class FileBackend;
+	class MemoryIStream;
+	class MemoryOStream;
+	class FileIStream;
+	class FileOStream;
+	class ImageIoQueue;
+	template<CPixel TPixel> class ImageSequenceReader;
+
+	class RemapTable;
+	template<CPixel TPixel> class DrawList;
+
 	enum class ImageFormat;
+	enum class GaussianMethod;
+	enum class BlendMode;
 	template<CPixel TPixel> class Image;
 	template<typename T> concept CImage = requires { typename T::PixelType; } && CPixel<typename T::PixelType> && std::derived_from<T, Image<typename T::PixelType>>;
 
+	template<CPixel TPixel, bool Squared = false> class IntegralImage;
+
+	enum class PyramidType;
+	template<CPixel TPixel> class ImagePyramid;
+
 }
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	template<CPixel TPixel>
+	class DrawList
+	{
+		public:
+
+			// Shapes are clipped to a width x height image when added, and drawn in the order they were added
+
+			constexpr DrawList(uint64_t width, uint64_t height);
+			constexpr DrawList(const DrawList<TPixel>& drawList) = default;
+			constexpr DrawList(DrawList<TPixel>&& drawList) = default;
+
+			constexpr DrawList<TPixel>& operator=(const DrawList<TPixel>& drawList) = default;
+			constexpr DrawList<TPixel>& operator=(DrawList<TPixel>&& drawList) = default;
+
+			template<CSpanShape TShape> constexpr void add(const TShape& shape, const TPixel& color);
+			constexpr void clear();
+
+			constexpr uint64_t getWidth() const;
+			constexpr uint64_t getHeight() const;
+			constexpr uint64_t getShapeCount() const;
+			constexpr uint64_t getSpanCount() const;
+
+			constexpr ~DrawList() = default;
+
+		private:
+
+			struct Span
+			{
+				uint32_t y;
+				uint32_t xBegin;
+				uint32_t xEnd;
+				uint32_t color;	// Index in _colors
+			};
+
+			static constexpr uint64_t _bandBytes = 1 << 18;	// Rows of a band should stay in L2 while all its spans are drawn
+
+			uint64_t _width;
+			uint64_t _height;
+			uint8_t _bandShift;
+
+			std::vector<TPixel> _colors;
+			std::vector<std::vector<Span>> _bands;	// Spans of rows [i << _bandShift, (i + 1) << _bandShift), in insertion order
+			uint64_t _spanCount;
+
+		template<CPixel T> friend class Image;
+	};
+}
@@ -16,7 +16,23 @@ namespace djv
 		Pbm,
 		Pgm,
 		Ppm,
-		Pnm
+		Pnm,
+		Jpeg,
+		Png,
+		Djv	// Raw pixels, stored as is
+	};
+
+	enum class GaussianMethod
+	{
+		Convolution,	// Exact kernel truncated at 3 sigma, cost grows linearly with sigma
+		Box,			// Three successive mean blurs with the same variance, constant cost per pixel
+		Recursive		// Young - van Vliet IIR filter, constant cost per pixel
+	};
+
+	enum class BlendMode
+	{
+		Over,	// d = s + d * (1 - sa), with s premultiplied by its alpha
+		Add		// d = min(s + d, 1)
 	};
 
 
@@ -36,20 +52,22 @@ namespace djv
 			constexpr Image(uint64_t width, uint64_t height);
 			constexpr Image(uint64_t width, uint64_t height, const TPixel& value);
 			constexpr Image(uint64_t width, uint64_t height, const TPixel* values);
-			constexpr Image(const std::filesystem::path& path);
-			constexpr Image(const std::filesystem::path& path, const uint8_t* swizzling);
-			constexpr Image(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling);
-			constexpr Image(const dsk::IStream* stream, ImageFormat format);
-			constexpr Image(const dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling);
-			constexpr Image(const dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling);
+			constexpr Image(const std::filesystem::path& path, FileBackend backend = FileBackend::Buffered);
+			constexpr Image(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend = FileBackend::Buffered);
+			constexpr Image(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend = FileBackend::Buffered);
+			constexpr Image(dsk::IStream* stream, ImageFormat format);
+			constexpr Image(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling);
+			constexpr Image(dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling);
 			template<CImage TImage> constexpr Image(const TImage& image);
 			template<CImage TImage> constexpr Image(const TImage& image, const PixelConversionFunction<typename TImage::PixelType, TPixel>& conversionFunc);
 			constexpr Image(const Image<TPixel>& image, uint64_t width, uint64_t height, scp::InterpolationMethod method);
+			constexpr Image(const Image<TPixel>& image, uint64_t width, uint64_t height, ResamplingFilter filter);
 			constexpr Image(const Image<TPixel>& image, uint64_t x, uint64_t y, uint64_t width, uint64_t height);
 			constexpr Image(const Image<TPixel>& image);
 			constexpr Image(Image<TPixel>&& image);
 
 			static constexpr Image<TPixel>* constructAroundMemory(uint64_t width, uint64_t height, TPixel* memory);
+			static constexpr Image<TPixel>* constructAroundMemory(void* djvFile, uint64_t size);	// Wraps the pixels of a memory-mapped .djv file, returns nullptr if they are not TPixel
 
 			constexpr Image<TPixel>& operator=(const Image<TPixel>& image);
 			constexpr Image<TPixel>& operator=(Image<TPixel>&& image);
@@ -59,43 +77,64 @@ namespace djv
 			constexpr void createNew(uint64_t width, uint64_t height);
 			constexpr void createNew(uint64_t width, uint64_t height, const TPixel& value);
 			constexpr void createNew(uint64_t width, uint64_t height, const TPixel* values);
-			constexpr void createFromFile(const std::filesystem::path& path);
-			constexpr void createFromFile(const std::filesystem::path& path, const uint8_t* swizzling);
-			constexpr void createFromFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling);
-			constexpr void createFromStream(const dsk::IStream* stream, ImageFormat format);
-			constexpr void createFromStream(const dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling);
-			constexpr void createFromStream(const dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling);
+			constexpr void createFromFile(const std::filesystem::path& path, FileBackend backend = FileBackend::Buffered);	// The backend only changes how the file is read, see FileBackend
+			constexpr void createFromFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend = FileBackend::Buffered);
+			constexpr void createFromFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend = FileBackend::Buffered);
+			constexpr void createFromFile(const std::filesystem::path& path, uint64_t width, uint64_t height, scp::InterpolationMethod method, FileBackend backend = FileBackend::Buffered);	// Rows are resampled while being decoded, the full size image is never stored
+			constexpr void createFromFile(const std::filesystem::path& path, uint64_t width, uint64_t height, ResamplingFilter filter, FileBackend backend = FileBackend::Buffered);
+			constexpr void createFromStream(dsk::IStream* stream, ImageFormat format);
+			constexpr void createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling);
+			constexpr void createFromStream(dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling);
 			template<CImage TImage> constexpr void createFromConversion(const TImage& image);
 			template<CImage TImage> constexpr void createFromConversion(const TImage& image, const PixelConversionFunction<typename TImage::PixelType, TPixel>& conversionFunc);
 			template<scp::InterpolationMethod IMethod> constexpr void createFromResize(const Image<TPixel>& image, uint64_t width, uint64_t height);
+			constexpr void createFromResize(const Image<TPixel>& image, uint64_t width, uint64_t height, ResamplingFilter filter);	// Separable resampling, any ratio
 			constexpr void createFromCrop(const Image<TPixel>& image, uint64_t x, uint64_t y, uint64_t width, uint64_t height);
+			constexpr void createFromTranspose(const Image<TPixel>& image);	// Reuses the current buffer if it already has the right size
+			constexpr void createFromYuv(const fmt::Y4mIStream& stream);
+			constexpr void createFromYuv(const fmt::Y4mIStream& stream, fmt::y4m::ColorMatrix matrix);	// Converts the last frame read to RGB, or to luma for images with less than 3 components
 
 			// Image save to format
 
-			constexpr void saveToFile(const std::filesystem::path& path) const;
-			constexpr void saveToFile(const std::filesystem::path& path, const uint8_t* swizzling) const;	// {0, 3, -1, -1} means red is first component, green is fourth component, blue is set to 0 and alpha is 255
-			constexpr void saveToFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling) const;
-			constexpr void saveToStream(const dsk::OStream* stream, ImageFormat format);
-			constexpr void saveToStream(const dsk::OStream* stream, ImageFormat format, const uint8_t* swizzling);
-			constexpr void saveToStream(const dsk::OStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling);
+			constexpr void saveToFile(const std::filesystem::path& path, FileBackend backend = FileBackend::Buffered) const;
+			constexpr void saveToFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend = FileBackend::Buffered) const;	// {0, 3, -1, -1} means red is first component, green is fourth component, blue is set to 0 and alpha is 255
+			constexpr void saveToFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend = FileBackend::Buffered) const;
+			constexpr void saveToStream(dsk::OStream* stream, ImageFormat format) const;
+			constexpr void saveToStream(dsk::OStream* stream, ImageFormat format, const uint8_t* swizzling) const;
+			constexpr void saveToStream(dsk::OStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling) const;
 
 			// Simple image manipulation
 
 			// TODO: resize
 			// TODO: crop
 			constexpr void transpose();
+			constexpr void rotate90();	// Counterclockwise, same as rotate(pi / 2)
+			constexpr void rotate180();
+			constexpr void rotate270();
 			template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour> constexpr void rotate(float angle);
+			template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour> constexpr void warpAffine(const std::array<float, 6>& matrix, uint64_t width, uint64_t height);	// Row-major 2x3 matrix from destination to source coordinates
+			template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour> constexpr void warpPerspective(const std::array<float, 9>& matrix, uint64_t width, uint64_t height);	// Row-major 3x3 homography from destination to source coordinates
+			constexpr void remap(const RemapTable& table, Image<TPixel>& destination) const;
 
 			template<bool Vertically, bool Horizontally> constexpr void flip();
 			template<CShape TShape> constexpr void draw(const TShape& shape, const TPixel& color);
 			template<CShape TShape> constexpr void draw(const TShape& shape, const Image<TPixel>& image);
+			constexpr void draw(const DrawList<TPixel>& drawList);	// The draw list must have been created with the size of the image
+
+			// Compositing, for RGBA u8 and f32 images with premultiplied alpha
+
+			constexpr void blend(const Image<TPixel>& image, int64_t x, int64_t y, BlendMode mode);	// Image is placed with its top-left corner at (x, y)
+			constexpr void blend(const Image<TPixel>& image, int64_t x, int64_t y, BlendMode mode, float alpha);	// Image is also multiplied by alpha
+			template<CShape TShape> constexpr void draw(const TShape& shape, const Image<TPixel>& image, int64_t xOffset, int64_t yOffset, BlendMode mode, float alpha);	// Pixel (x, y) of the shape is blended with pixel (x - xOffset, y - yOffset) of image
 
 			// Blurs
 
-			template<scp::BorderBehaviour BBehaviour> constexpr void blurGaussian(float sigma);
-			template<scp::BorderBehaviour BBehaviour> constexpr void blurGaussian(float sigmaX, float sigmaY);
+			template<scp::BorderBehaviour BBehaviour, GaussianMethod GMethod = GaussianMethod::Convolution> constexpr void blurGaussian(float sigma);
+			template<scp::BorderBehaviour BBehaviour, GaussianMethod GMethod = GaussianMethod::Convolution> constexpr void blurGaussian(float sigmaX, float sigmaY);
 			template<scp::BorderBehaviour BBehaviour> constexpr void blurMean(uint64_t radius);
 			template<scp::BorderBehaviour BBehaviour> constexpr void blurMean(uint64_t radiusX, uint64_t radiusY);
+			constexpr void blurMean(const IntegralImage<TPixel>& integral, uint64_t radius);	// Borders are those the integral was computed with, its padding must cover the radii
+			constexpr void blurMean(const IntegralImage<TPixel>& integral, uint64_t radiusX, uint64_t radiusY);
 			template<scp::BorderBehaviour BBehaviour> constexpr void blurMedian(uint64_t radius);
 			template<scp::BorderBehaviour BBehaviour> constexpr void blurMedian(uint64_t radiusX, uint64_t radiusY);
 
@@ -145,28 +184,47 @@ namespace djv
 			constexpr void _copyFrom(const Image<TPixel>& image);
 			constexpr void _moveFrom(Image<TPixel>&& image);
 			constexpr void _destroy();
-
-			constexpr void _createFromFile(const std::filesystem::path& path, const uint8_t* swizzling);
-			constexpr void _createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling);
+			constexpr void _resample(const Image<TPixel>& image, ResamplingFilter filter);
+			constexpr void _transposeReplace(int64_t sourceOffset, int64_t sourceStride, int64_t destinationOffset, int64_t destinationStride);
+			template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour, bool Perspective> constexpr void _warp(const float* matrix, uint64_t width, uint64_t height);
+			template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour, bool Interior> constexpr void _sample(float x, float y, TPixel& pixel) const;
+			template<scp::BorderBehaviour BBehaviour> constexpr void _blurGaussianRecursive(float sigmaX, float sigmaY);
+			template<scp::BorderBehaviour BBehaviour, typename TSum> constexpr void _blurMean(uint64_t radiusX, uint64_t radiusY);
+
+			constexpr void _createFromFile(const std::filesystem::path& path, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler, FileBackend backend);
+			constexpr void _createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler);
+			constexpr void _beginLoad(uint64_t width, uint64_t height, _djv::StreamResampler<TPixel>*& resampler);
 			
-			template<ImageFormat Format> constexpr void _createFromPnm(dsk::IStream* stream, const uint8_t* swizzling);
+			template<ImageFormat Format> constexpr void _createFromPnm(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler);
+			constexpr void _createFromJpeg(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler);
+			constexpr void _createFromPng(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler);
+			constexpr void _createFromDjv(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler);
 
-			constexpr void _saveToFile(const std::filesystem::path& path, const uint8_t* swizzling) const;
+			constexpr void _saveToFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend) const;
 			constexpr void _saveToStream(dsk::OStream* stream, ImageFormat format, const uint8_t* swizzling) const;
 
 			template<ImageFormat Format> constexpr void _saveToPnm(dsk::OStream* stream, const uint8_t* swizzling) const;
+			constexpr void _saveToJpeg(dsk::OStream* stream, const uint8_t* swizzling) const;
+			constexpr void _saveToPng(dsk::OStream* stream, const uint8_t* swizzling) const;
+			constexpr void _saveToDjv(dsk::OStream* stream, const uint8_t* swizzling) const;
 
-			static constexpr void (Image<TPixel>::*_imageFormatToLoadFunc[])(dsk::IStream*, const uint8_t*) = {
+			static constexpr void (Image<TPixel>::*_imageFormatToLoadFunc[])(dsk::IStream*, const uint8_t*, _djv::StreamResampler<TPixel>*) = {
 				&Image<TPixel>::_createFromPnm<ImageFormat::Pbm>,
 				&Image<TPixel>::_createFromPnm<ImageFormat::Pgm>,
 				&Image<TPixel>::_createFromPnm<ImageFormat::Ppm>,
-				&Image<TPixel>::_createFromPnm<ImageFormat::Pnm>
+				&Image<TPixel>::_createFromPnm<ImageFormat::Pnm>,
+				&Image<TPixel>::_createFromJpeg,
+				&Image<TPixel>::_createFromPng,
+				&Image<TPixel>::_createFromDjv
 			};
 			static constexpr void (Image<TPixel>::*_imageFormatToSaveFunc[])(dsk::OStream*, const uint8_t*) const = {
 				&Image<TPixel>::_saveToPnm<ImageFormat::Pbm>,
 				&Image<TPixel>::_saveToPnm<ImageFormat::Pgm>,
 				&Image<TPixel>::_saveToPnm<ImageFormat::Ppm>,
-				&Image<TPixel>::_saveToPnm<ImageFormat::Pnm>
+				&Image<TPixel>::_saveToPnm<ImageFormat::Pnm>,
+				&Image<TPixel>::_saveToJpeg,
+				&Image<TPixel>::_saveToPng,
+				&Image<TPixel>::_saveToDjv
 			};
 			static constexpr bool _extensionToImageFormat(const std::filesystem::path& extension, ImageFormat& format);
 
@@ -182,6 +240,8 @@ namespace djv
 			bool _owner;
 
 		template<CPixel T> friend class Image;
+		friend class ImageIoQueue;
+		template<CPixel T> friend class ImageSequenceReader;
 	};
 
 	using Image_gs_u8 = Image<Pixel_gs_u8>;
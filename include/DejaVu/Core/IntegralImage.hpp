@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		// Sums of u8 fit in 32 bits for boxes of up to 2^24 pixels, and the unsigned wrap-around of the table cancels out in
+		// box sums. Everything else uses 64 bits, and double for floating point components.
+
+		template<typename TComponent, bool Squared>
+		using IntegralAccumulator = std::conditional_t<
+			std::floating_point<TComponent>,
+			double,
+			std::conditional_t<
+				std::same_as<TComponent, uint8_t> && !Squared,
+				uint32_t,
+				std::conditional_t<std::signed_integral<TComponent> && !Squared, int64_t, uint64_t>
+			>
+		>;
+	}
+
+	template<CPixel TPixel, bool Squared>
+	class IntegralImage
+	{
+		static_assert(!Squared || std::floating_point<typename TPixel::ComponentType> || sizeof(typename TPixel::ComponentType) <= 2);	// Squares of 32-bit components overflow 64-bit sums
+
+		public:
+
+			using PixelType = TPixel;
+			using ComponentType = typename TPixel::ComponentType;
+			using AccumulatorType = _djv::IntegralAccumulator<ComponentType, Squared>;
+			static constexpr uint8_t componentCount = TPixel::componentCount;
+
+			// The table covers the image extended by xPadding and yPadding pixels on each side, pixels out of the image are
+			// given by the border behaviour passed to compute
+
+			constexpr IntegralImage(uint64_t width, uint64_t height);
+			constexpr IntegralImage(uint64_t width, uint64_t height, uint64_t xPadding, uint64_t yPadding);
+			constexpr IntegralImage(const Image<TPixel>& image);	// Without padding
+			constexpr IntegralImage(const IntegralImage<TPixel, Squared>& integral) = default;
+			constexpr IntegralImage(IntegralImage<TPixel, Squared>&& integral) = default;
+
+			constexpr IntegralImage<TPixel, Squared>& operator=(const IntegralImage<TPixel, Squared>& integral) = default;
+			constexpr IntegralImage<TPixel, Squared>& operator=(IntegralImage<TPixel, Squared>&& integral) = default;
+
+			template<scp::BorderBehaviour BBehaviour> constexpr void compute(const Image<TPixel>& image);	// The image must have the size given at construction
+
+			constexpr std::array<AccumulatorType, componentCount> sum(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const;	// Sum over [x0, x1) x [y0, y1), squared components if Squared. Must lie in the padded image.
+
+			constexpr uint64_t getWidth() const;
+			constexpr uint64_t getHeight() const;
+			constexpr uint64_t getXPadding() const;
+			constexpr uint64_t getYPadding() const;
+
+			constexpr ~IntegralImage() = default;
+
+		private:
+
+			uint64_t _width;
+			uint64_t _height;
+			uint64_t _xPadding;
+			uint64_t _yPadding;
+
+			uint64_t _rowSize;	// Components in a row of the table, which has one more row and column than the padded image
+			std::vector<AccumulatorType> _sums;	// Entry (x, y) is the sum over [-xPadding, x - xPadding) x [-yPadding, y - yPadding)
+	};
+
+	template<CPixel TPixel>
+	using SquaredIntegralImage = IntegralImage<TPixel, true>;
+}
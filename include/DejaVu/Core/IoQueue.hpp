@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		class ThreadPool
+		{
+			public:
+
+				ThreadPool(uint32_t threadCount);
+				ThreadPool(const ThreadPool& pool) = delete;
+				ThreadPool(ThreadPool&& pool) = delete;
+
+				ThreadPool& operator=(const ThreadPool& pool) = delete;
+				ThreadPool& operator=(ThreadPool&& pool) = delete;
+
+				void push(std::move_only_function<void()>&& task);
+
+				~ThreadPool();	// Pending tasks are run before the threads are joined
+
+			private:
+
+				void _run();
+
+				std::vector<std::thread> _threads;
+				std::deque<std::move_only_function<void()>> _tasks;
+				std::mutex _mutex;
+				std::condition_variable _condition;
+				bool _stopping;
+		};
+	}
+
+	class ImageIoQueue
+	{
+		public:
+
+			ImageIoQueue(uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u), uint32_t queueDepth = 128);
+			ImageIoQueue(const ImageIoQueue& queue) = delete;
+			ImageIoQueue(ImageIoQueue&& queue) = delete;
+
+			ImageIoQueue& operator=(const ImageIoQueue& queue) = delete;
+			ImageIoQueue& operator=(ImageIoQueue&& queue) = delete;
+
+			// The image must stay alive and untouched until the future is ready, errors are reported in its status
+
+			template<CPixel TPixel> std::future<void> load(Image<TPixel>& image, const std::filesystem::path& path);
+			template<CPixel TPixel> std::future<void> save(const Image<TPixel>& image, const std::filesystem::path& path);
+
+			bool isAsynchronous() const;	// False when io_uring is not available, files are then read and written by the worker threads
+
+			~ImageIoQueue();	// Waits for every pending operation
+
+		private:
+
+			struct Request
+			{
+				int descriptor;
+				bool write;
+				std::vector<uint8_t> data;
+				uint64_t done;
+				std::move_only_function<void(bool)> complete;
+			};
+
+			Request* _openRequest(const std::filesystem::path& path, bool write);
+			void _submit(Request* request, bool newRequest);
+			void _complete(Request* request, bool success);
+			void _finish(std::promise<void>& promise);
+
+			bool _setupRing(uint32_t queueDepth);
+			void _destroyRing();
+			bool _pushEntry(uint8_t opcode, int descriptor, uint8_t* data, uint32_t size, uint64_t offset, uint64_t userData);	// Returns false if the entry could not be submitted, it is then removed from the ring
+			void _reap();
+
+
+			_djv::ThreadPool _pool;
+
+			std::mutex _mutex;
+			std::condition_variable _condition;
+			uint64_t _pending;
+			uint32_t _inFlight;
+
+			int _ring;
+			uint32_t _queueDepth;
+#ifdef DJV_IO_URING
+			uint8_t* _sqRing;
+			uint64_t _sqRingSize;
+			uint8_t* _cqRing;
+			uint64_t _cqRingSize;
+			io_uring_sqe* _sqes;
+			uint64_t _sqesSize;
+
+			uint32_t* _sqTail;
+			uint32_t* _sqMask;
+			uint32_t* _sqArray;
+			uint32_t* _cqHead;
+			uint32_t* _cqTail;
+			uint32_t* _cqMask;
+			io_uring_cqe* _cqes;
+
+			std::mutex _submitMutex;
+			std::thread _completionThread;
+#endif
+	};
+}
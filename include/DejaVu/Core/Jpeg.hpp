@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace fmt
+	{
+		namespace jpeg
+		{
+			enum class ColorTransform
+			{
+				None,
+				YCbCr,
+				YCCK
+			};
+
+			struct Header
+			{
+				uint16_t width;
+				uint16_t height;
+				uint8_t componentCount;
+				bool progressive;
+			};
+		}
+
+		class JpegIStream
+		{
+			public:
+
+				JpegIStream(dsk::IStream* stream);
+				JpegIStream(const JpegIStream& stream) = delete;
+				JpegIStream(JpegIStream&& stream) = delete;
+
+				JpegIStream& operator=(const JpegIStream& stream) = delete;
+				JpegIStream& operator=(JpegIStream&& stream) = delete;
+
+				void readHeader(jpeg::Header& header);
+				void setScaleDenominator(uint8_t denominator);	// 1, 2, 4 or 8 - the IDCT directly outputs 8/denominator pixels per block side
+				void readPixels(uint8_t* samples, uint64_t pixelCount);
+
+				uint64_t getOutputWidth() const;
+				uint64_t getOutputHeight() const;
+				uint8_t getOutputComponentCount() const;
+				const ruc::Status& getStatus() const;
+
+				~JpegIStream() = default;
+
+			private:
+
+				struct HuffmanTable
+				{
+					uint16_t lookup[1 << 9];
+					int32_t maxCode[18];
+					int32_t valueOffset[17];
+					uint8_t values[256];
+				};
+
+				struct Component
+				{
+					uint8_t id;
+					uint8_t h;
+					uint8_t v;
+					uint8_t quantTable;
+					uint8_t dcTable;
+					uint8_t acTable;
+
+					uint64_t blockWidth;
+					uint64_t blockHeight;
+					uint64_t blocksPerLine;
+					uint64_t blocksPerColumn;
+					uint8_t blockSize;
+
+					int32_t dcPred;
+					std::vector<int16_t> coefs;
+					std::vector<uint8_t> plane;
+					std::vector<uint8_t> upsampled;
+				};
+
+				bool _read(uint8_t* data, uint64_t size);
+				bool _readMarker(uint8_t& marker);
+				bool _readSegment(std::vector<uint8_t>& segment);
+				bool _readQuantizationTables();
+				bool _readHuffmanTables();
+				bool _readRestartInterval();
+				bool _readApplicationSegment(uint8_t marker);
+				bool _readFrame(uint8_t marker);
+				bool _readScanHeader();
+				bool _readTablesUntilScan(bool& endOfImage);
+
+				void _allocate();
+				bool _decodeScan();
+				bool _decodeAllScans();
+				bool _decodeMcuRow();
+				void _outputMcuRow();
+
+				void _decodeBlockBaseline(Component& component, int16_t* coefs);
+				void _decodeBlockDcFirst(Component& component, int16_t* coefs);
+				void _decodeBlockDcRefine(int16_t* coefs);
+				void _decodeBlockAcFirst(Component& component, int16_t* coefs);
+				void _decodeBlockAcRefine(Component& component, int16_t* coefs);
+				bool _processRestart();
+
+				void _fillBits();
+				uint32_t _getBits(uint8_t count);
+				uint32_t _getBit();
+				uint8_t _decodeHuffman(const HuffmanTable& table);
+				static int32_t _extend(uint32_t value, uint8_t size);
+				static void _buildHuffmanTable(HuffmanTable& table, const uint8_t* counts, const uint8_t* values);
+
+				void _idct(const int16_t* coefs, const uint16_t* quantTable, uint8_t* output, uint64_t stride, uint8_t blockSize) const;
+
+
+				static constexpr uint8_t _zigzag[64 + 16] = {
+					0,  1,  8,  16, 9,  2,  3,  10,
+					17, 24, 32, 25, 18, 11, 4,  5,
+					12, 19, 26, 33, 40, 48, 41, 34,
+					27, 20, 13, 6,  7,  14, 21, 28,
+					35, 42, 49, 56, 57, 50, 43, 36,
+					29, 22, 15, 23, 30, 37, 44, 51,
+					58, 59, 52, 45, 38, 31, 39, 46,
+					53, 60, 61, 54, 47, 55, 62, 63,
+					63, 63, 63, 63, 63, 63, 63, 63,	// Extra entries so that corrupted run-lengths stay in the block
+					63, 63, 63, 63, 63, 63, 63, 63
+				};
+
+
+				dsk::IStream* _stream;
+				ruc::Status _status;
+
+				uint16_t _quantTables[4][64];
+				HuffmanTable _dcTables[4];
+				HuffmanTable _acTables[4];
+
+				uint16_t _width;
+				uint16_t _height;
+				bool _progressive;
+				jpeg::ColorTransform _colorTransform;
+				bool _adobeFound;
+				uint8_t _adobeTransform;
+
+				std::vector<Component> _components;
+				uint8_t _hMax;
+				uint8_t _vMax;
+				uint64_t _mcusPerLine;
+				uint64_t _mcusPerColumn;
+
+				uint16_t _restartInterval;
+				uint16_t _restartsLeft;
+
+				uint8_t _scanComponents[4];
+				uint8_t _scanComponentCount;
+				uint8_t _spectralStart;
+				uint8_t _spectralEnd;
+				uint8_t _approxHigh;
+				uint8_t _approxLow;
+				uint32_t _eobRun;
+
+				uint64_t _bitBuffer;
+				uint8_t _bitCount;
+				uint8_t _pendingMarker;
+
+				bool _fullBuffer;
+				bool _allocated;
+				uint8_t _blockSize;
+				int32_t _scaledTables[2][4][4];
+
+				uint64_t _mcuRow;
+				std::vector<uint8_t> _rows;
+				uint64_t _rowsPos;
+				uint64_t _rowsEnd;
+		};
+	}
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace fmt
+	{
+		namespace native
+		{
+			enum class ComponentKind : uint8_t
+			{
+				Unsigned,
+				Signed,
+				Float
+			};
+
+			struct Header	// Stored as is at the beginning of .djv files, the pixels are stored as is at dataOffset
+			{
+				char signature[8];
+				uint32_t version;
+				uint8_t littleEndian;
+				ComponentKind componentKind;
+				uint8_t componentSize;
+				uint8_t componentCount;
+				uint64_t width;
+				uint64_t height;
+				uint64_t stride;	// Bytes between the beginning of two rows
+				uint64_t dataOffset;	// Multiple of pageSize, so that the pixels of a memory-mapped file are page-aligned
+				uint8_t reserved[16];
+			};
+
+			static_assert(sizeof(Header) == 64);
+
+			constexpr char signature[8] = { 'D', 'J', 'V', 'R', 'A', 'W', '\r', '\n' };
+			constexpr uint32_t version = 1;
+			constexpr uint64_t pageSize = 4096;
+
+			template<CPixel TPixel> constexpr Header createHeader(uint64_t width, uint64_t height);
+			template<CPixel TPixel> constexpr bool isCompatible(const Header& header);	// Whether the pixels can be used as is as TPixel
+		}
+	}
+}
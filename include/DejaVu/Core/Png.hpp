@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace fmt
+	{
+		namespace png
+		{
+			enum class ColorType : uint8_t
+			{
+				Grayscale = 0,
+				Truecolor = 2,
+				IndexedColor = 3,
+				GrayscaleAlpha = 4,
+				TruecolorAlpha = 6
+			};
+
+			enum class CompressionLevel
+			{
+				Store,	// No filtering, uncompressed deflate blocks
+				Rle,	// Adaptive filtering, only runs of repeated bytes are compressed
+				Fast	// Adaptive filtering, single-probe hashed LZ77
+			};
+
+			struct Header
+			{
+				uint32_t width;
+				uint32_t height;
+				uint8_t bitDepth;
+				ColorType colorType;
+				bool interlaced;
+			};
+		}
+
+		class PngIStream
+		{
+			public:
+
+				PngIStream(dsk::IStream* stream);
+				PngIStream(const PngIStream& stream) = delete;
+				PngIStream(PngIStream&& stream) = delete;
+
+				PngIStream& operator=(const PngIStream& stream) = delete;
+				PngIStream& operator=(PngIStream&& stream) = delete;
+
+				void readHeader(png::Header& header);
+				void readPixels(uint16_t* samples, uint64_t pixelCount);	// Palettes and tRNS are expanded, samples are in [0, getOutputMaxSampleValue()]
+
+				uint8_t getOutputComponentCount() const;
+				uint16_t getOutputMaxSampleValue() const;
+				const ruc::Status& getStatus() const;
+
+				~PngIStream() = default;
+
+			private:
+
+				struct HuffmanTable
+				{
+					uint16_t lookup[1 << 9];
+					uint16_t counts[16];
+					uint16_t symbols[288];
+				};
+
+				bool _read(uint8_t* data, uint64_t size);
+				bool _readChunkHeader(uint32_t& length, uint32_t& type);
+				bool _skipChunk(uint32_t length);
+				bool _readImageHeader(uint32_t length);
+				bool _readPalette(uint32_t length);
+				bool _readTransparency(uint32_t length);
+
+				bool _refillInput();
+				void _fillBits();
+				bool _getBits(uint8_t count, uint32_t& value);
+				bool _decodeHuffman(const HuffmanTable& table, uint16_t& symbol);
+				static bool _buildHuffmanTable(HuffmanTable& table, const uint8_t* lengths, uint16_t count);
+
+				bool _readBlockHeader();
+				bool _readDynamicTables();
+				bool _readStoredBytes(uint8_t* data, uint64_t size);
+				bool _inflate(uint8_t* data, uint64_t size);
+
+				bool _readRow(uint64_t rowSize);
+				void _expandRow(uint16_t* samples, uint64_t width) const;
+				bool _deinterlace();
+
+
+				dsk::IStream* _stream;
+				ruc::Status _status;
+
+				uint32_t _width;
+				uint32_t _height;
+				uint8_t _bitDepth;
+				png::ColorType _colorType;
+				bool _interlaced;
+				uint8_t _channelCount;
+				uint8_t _bytesPerPixel;
+
+				uint8_t _palette[256][4];
+				uint16_t _paletteSize;
+				bool _transparency;
+				uint16_t _transparentColor[3];
+
+				uint32_t _idatRemaining;
+				bool _idatEnded;
+				std::vector<uint8_t> _input;
+				uint64_t _inputPos;
+				uint64_t _inputEnd;
+				uint64_t _bitBuffer;
+				uint8_t _bitCount;
+
+				bool _inBlock;
+				bool _finalBlock;
+				uint8_t _blockType;
+				uint16_t _storedRemaining;
+				uint16_t _matchLength;
+				uint16_t _matchDistance;
+				HuffmanTable _literalTable;
+				HuffmanTable _distanceTable;
+				std::vector<uint8_t> _window;
+				uint16_t _windowPos;
+				uint64_t _totalOut;
+
+				std::vector<uint8_t> _row;
+				std::vector<uint8_t> _previousRow;
+				std::vector<uint16_t> _samples;
+				uint64_t _samplesPos;
+				uint64_t _samplesEnd;
+				uint32_t _y;
+		};
+
+		class PngOStream
+		{
+			public:
+
+				PngOStream(dsk::OStream* stream);
+				PngOStream(const PngOStream& stream) = delete;
+				PngOStream(PngOStream&& stream) = delete;
+
+				PngOStream& operator=(const PngOStream& stream) = delete;
+				PngOStream& operator=(PngOStream&& stream) = delete;
+
+				void setCompressionLevel(png::CompressionLevel level);
+				void writeHeader(const png::Header& header);
+				void writePixels(const uint16_t* samples, uint64_t pixelCount);	// Rows are compressed as soon as they are complete, the stream is terminated after the last one
+
+				const ruc::Status& getStatus() const;
+
+				~PngOStream() = default;
+
+			private:
+
+				bool _write(const uint8_t* data, uint64_t size);
+				bool _writeChunk(const char* type, const uint8_t* data, uint32_t size);
+				bool _writeIdat(bool force);
+
+				void _putBits(uint32_t bits, uint8_t count);
+				void _alignBits();
+				void _putLiteral(uint16_t literal);
+				void _putMatch(uint16_t length, uint16_t distance);
+
+				void _filterRow();
+				bool _deflate(const uint8_t* data, uint64_t size);
+				void _compress(uint64_t pos, uint64_t end);
+				bool _finish();
+
+
+				static constexpr uint32_t _windowSize = 1 << 15;
+				static constexpr uint32_t _hashSize = 1 << 15;
+				static constexpr uint32_t _idatSize = 1 << 16;
+
+
+				dsk::OStream* _stream;
+				ruc::Status _status;
+
+				png::CompressionLevel _level;
+				uint32_t _width;
+				uint32_t _height;
+				uint8_t _bitDepth;
+				uint8_t _channelCount;
+				uint8_t _bytesPerPixel;
+				uint64_t _rowSize;
+
+				std::vector<uint8_t> _row;
+				std::vector<uint8_t> _previousRow;
+				std::vector<uint8_t> _filtered;
+				uint64_t _rowPos;
+				uint32_t _y;
+
+				uint16_t _literalCodes[286];
+				uint8_t _literalLengths[286];
+				uint8_t _lengthSymbols[256];
+
+				std::vector<uint8_t> _history;
+				uint64_t _historyStart;
+				uint64_t _historyEnd;
+				std::vector<uint64_t> _hashHeads;
+				std::vector<uint8_t> _stored;
+				uint32_t _adler[2];
+
+				std::vector<uint8_t> _idat;
+				uint64_t _bitBuffer;
+				uint8_t _bitCount;
+		};
+	}
+}
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	enum class PyramidType
+	{
+		Gaussian,
+		Laplacian	// Band-pass levels, the last level is the coarsest Gaussian level
+	};
+
+	namespace _djv
+	{
+		// Wide enough for the difference of two components, so that Laplacian levels are never clipped
+
+		template<typename TComponent>
+		using LaplacianComponent = std::conditional_t<
+			std::floating_point<TComponent>,
+			TComponent,
+			std::conditional_t<sizeof(TComponent) == 1, int16_t, std::conditional_t<sizeof(TComponent) == 2, int32_t, int64_t>>
+		>;
+	}
+
+	template<CPixel TPixel>
+	class ImagePyramid
+	{
+		public:
+
+			using PixelType = TPixel;
+			using ComponentType = typename TPixel::ComponentType;
+			using LaplacianPixelType = Pixel<_djv::LaplacianComponent<ComponentType>, TPixel::componentCount>;
+			static constexpr uint8_t componentCount = TPixel::componentCount;
+
+			constexpr ImagePyramid(const Image<TPixel>& image, uint64_t levelCount);
+			constexpr ImagePyramid(const Image<TPixel>& image, uint64_t levelCount, PyramidType type);	// Stops early if a level reaches 1x1
+			ImagePyramid(const ImagePyramid<TPixel>& pyramid) = delete;
+			ImagePyramid(ImagePyramid<TPixel>&& pyramid) = delete;
+
+			ImagePyramid<TPixel>& operator=(const ImagePyramid<TPixel>& pyramid) = delete;
+			ImagePyramid<TPixel>& operator=(ImagePyramid<TPixel>&& pyramid) = delete;
+
+			constexpr const Image<TPixel>& getLevel(uint64_t level);	// Gaussian pyramids only. Levels are built on first access.
+			constexpr const Image<LaplacianPixelType>& getLaplacianLevel(uint64_t level);	// Laplacian pyramids only. Levels are built on first access.
+			constexpr void reconstruct(Image<TPixel>& image);	// Collapses a Laplacian pyramid back to its base image, exactly for integer components
+
+			constexpr uint64_t getLevelCount() const;
+			constexpr PyramidType getType() const;
+
+			constexpr ~ImagePyramid();
+
+		private:
+
+			template<CPixel TLevelPixel> static constexpr void _allocateLevels(const std::vector<std::pair<uint64_t, uint64_t>>& sizes, TLevelPixel*& pixels, std::vector<Image<TLevelPixel>*>& levels);
+			constexpr void _buildLevel();
+
+			PyramidType _type;
+
+			TPixel* _pixels;	// Every level of a Gaussian pyramid, in a single allocation
+			std::vector<Image<TPixel>*> _levels;
+			LaplacianPixelType* _laplacianPixels;	// Same for a Laplacian pyramid
+			std::vector<Image<LaplacianPixelType>*> _laplacianLevels;
+			uint64_t _levelCount;
+			uint64_t _builtCount;
+
+			std::vector<float> _row;
+	};
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	using RemapFunction = std::function<void(uint64_t x, uint64_t y, float& sourceX, float& sourceY)>;
+
+	class RemapTable
+	{
+		public:
+
+			// Source coordinates are sampled bilinearly, with 8 bits of sub-pixel precision
+
+			RemapTable(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight, const RemapFunction& remapFunc, scp::BorderBehaviour borderBehaviour);
+			RemapTable(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight, const float* mapX, const float* mapY, scp::BorderBehaviour borderBehaviour);
+			RemapTable(const RemapTable& table) = default;
+			RemapTable(RemapTable&& table) = default;
+
+			RemapTable& operator=(const RemapTable& table) = default;
+			RemapTable& operator=(RemapTable&& table) = default;
+
+			uint64_t getWidth() const;
+			uint64_t getHeight() const;
+			uint64_t getSourceWidth() const;
+			uint64_t getSourceHeight() const;
+
+			~RemapTable() = default;
+
+		private:
+
+			struct Entry
+			{
+				uint32_t offset;	// Index of the top-left tap in the source image
+				uint8_t xFraction;
+				uint8_t yFraction;
+				uint8_t flags;
+			};
+
+			static constexpr uint8_t _hasRight = 1;
+			static constexpr uint8_t _hasBottom = 2;
+			static constexpr uint8_t _outside = 4;	// Written with the zero color of the source image
+
+			void _init(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight);
+			void _setEntry(Entry& entry, float x, float y, scp::BorderBehaviour borderBehaviour) const;
+
+			uint64_t _width;
+			uint64_t _height;
+			uint64_t _sourceWidth;
+			uint64_t _sourceHeight;
+
+			std::vector<Entry> _entries;
+
+		template<CPixel T> friend class Image;
+	};
+}
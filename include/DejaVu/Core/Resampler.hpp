@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	enum class ResamplingFilter
+	{
+		Nearest,
+		Box,		// Exact area coverage, the reference for downsampling
+		Linear,
+		Cubic,		// Keys cubic convolution, a = -0.5
+		Lanczos3
+	};
+
+	namespace _djv
+	{
+		struct ResamplingTable
+		{
+			std::vector<uint64_t> starts;
+			std::vector<uint32_t> counts;
+			std::vector<float> weights;	// weights[i * maxCount + t] is the weight of source starts[i] + t for destination i
+			uint32_t maxCount;
+		};
+
+		template<CPixel TPixel>
+		class StreamResampler
+		{
+			public:
+
+				using ComponentType = typename TPixel::ComponentType;
+				static constexpr uint8_t componentCount = TPixel::componentCount;
+
+				constexpr StreamResampler(uint64_t width, uint64_t height, ResamplingFilter filter);
+				StreamResampler(const StreamResampler<TPixel>& resampler) = delete;
+				StreamResampler(StreamResampler<TPixel>&& resampler) = delete;
+
+				StreamResampler<TPixel>& operator=(const StreamResampler<TPixel>& resampler) = delete;
+				StreamResampler<TPixel>& operator=(StreamResampler<TPixel>&& resampler) = delete;
+
+				constexpr void begin(TPixel* destination, uint64_t sourceWidth, uint64_t sourceHeight);
+				constexpr TPixel* getSourceRow();
+				constexpr void pushSourceRow();	// Source rows must be pushed in order, destination rows are written as soon as they are complete
+				constexpr void pushSourceRow(const TPixel* row);	// Same, without copying the row to getSourceRow() first
+
+				constexpr uint64_t getWidth() const;
+				constexpr uint64_t getHeight() const;
+
+				constexpr ~StreamResampler() = default;
+
+			private:
+
+				constexpr void _resampleRow(const TPixel* row, float* destination);
+				constexpr void _emitRow();
+
+				uint64_t _width;
+				uint64_t _height;
+				ResamplingFilter _filter;
+
+				TPixel* _destination;
+				uint64_t _sourceWidth;
+				uint64_t _sourceHeight;
+				ResamplingTable _xTable;
+				ResamplingTable _yTable;
+
+				std::vector<TPixel> _sourceRow;
+				std::vector<float> _rows;	// Ring of horizontally resampled rows
+				std::vector<float> _accumulator;
+				uint64_t _sourceY;
+				uint64_t _y;
+		};
+	}
+}
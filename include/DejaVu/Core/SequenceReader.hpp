@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	template<CPixel TPixel>
+	class ImageSequenceReader
+	{
+		public:
+
+			ImageSequenceReader(const std::vector<std::filesystem::path>& paths, uint32_t prefetchCount = 4);
+			ImageSequenceReader(const std::filesystem::path& directory, uint32_t prefetchCount = 4);	// Every image file of the directory, sorted by name
+			ImageSequenceReader(const ImageSequenceReader<TPixel>& reader) = delete;
+			ImageSequenceReader(ImageSequenceReader<TPixel>&& reader) = delete;
+
+			ImageSequenceReader<TPixel>& operator=(const ImageSequenceReader<TPixel>& reader) = delete;
+			ImageSequenceReader<TPixel>& operator=(ImageSequenceReader<TPixel>&& reader) = delete;
+
+			const Image<TPixel>* next();	// Returns nullptr after the last frame. The frame is valid until the next call, errors are reported in its status.
+
+			const std::vector<std::filesystem::path>& getPaths() const;
+			uint64_t getFrameCount() const;
+			uint64_t getFrameIndex() const;	// Index of the frame that the next call to next() returns
+
+			~ImageSequenceReader();	// Waits for the loads in progress
+
+		private:
+
+			struct Slot
+			{
+				Image<TPixel> image;
+				std::vector<uint8_t> data;	// Content of the file, the buffer is reused from a frame to the next
+				uint64_t index;	// Frame held by the slot once loaded
+			};
+
+			void _start(uint32_t prefetchCount);
+			void _run();
+			void _load(Slot& slot, const std::filesystem::path& path);
+
+			static bool _readFile(const std::filesystem::path& path, std::vector<uint8_t>& data, uint64_t& size);
+
+			std::vector<std::filesystem::path> _paths;
+
+			std::vector<Slot> _slots;	// Ring of prefetchCount + 1 frames, one of them is held by the caller
+			uint64_t _next;
+			uint64_t _loadNext;	// Next frame given to a worker thread
+			uint64_t _loadEnd;	// Frames before it have a free slot
+
+			std::vector<std::thread> _threads;
+			std::mutex _mutex;
+			std::condition_variable _condition;
+			bool _stopping;
+	};
+}
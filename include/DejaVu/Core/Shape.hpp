@@ -32,7 +32,23 @@ namespace djv
 					uint64_t _w, _h, _t;
 			};
 
+			class SpanGenerator
+			{
+				public:
+
+					constexpr SpanGenerator(int64_t left, int64_t top, uint64_t width, uint64_t height, uint64_t thickness, uint64_t clipWidth, uint64_t clipHeight);
+
+					constexpr bool getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd);	// Pixels [xBegin, xEnd) of row y, clipped to [0, clipWidth) x [0, clipHeight)
+
+				private:
+
+					int64_t _left, _right, _innerLeft, _innerRight, _bandTop, _bandBottom;
+					int64_t _y, _yEnd, _clipWidth;
+					bool _second;
+			};
+
 			constexpr Generator getGenerator() const;
+			constexpr SpanGenerator getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const;
 
 		private:
 
@@ -63,7 +79,23 @@ namespace djv
 					int64_t _x0, _y0, _x, _y, _lx, _ly;
 			};
 
+			class SpanGenerator
+			{
+				public:
+
+					constexpr SpanGenerator(int64_t xCenter, int64_t yCenter, uint64_t outerRadius, uint64_t innerRadius, uint64_t clipWidth, uint64_t clipHeight);
+
+					constexpr bool getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd);
+
+				private:
+
+					int64_t _cx, _cy, _irSq, _orSq;
+					int64_t _y, _yEnd, _clipWidth, _secondBegin, _secondEnd;
+					bool _second;
+			};
+
 			constexpr Generator getGenerator() const;
+			constexpr SpanGenerator getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const;
 
 		private:
 
@@ -93,7 +125,23 @@ namespace djv
 					int64_t _x1, _y1, _x2, _y2, _dx, _dy, _e, _e10, _e01, _x, _y;
 			};
 
+			class SpanGenerator
+			{
+				public:
+
+					constexpr SpanGenerator(int64_t xStart, int64_t yStart, int64_t xEnd, int64_t yEnd, uint64_t clipWidth, uint64_t clipHeight);
+
+					constexpr bool getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd);	// Consecutive pixels of a row are merged in a single span
+
+				private:
+
+					Generator _generator;
+					int64_t _clipWidth, _clipHeight, _x, _y;
+					bool _pending, _culled;
+			};
+
 			constexpr Generator getGenerator() const;
+			constexpr SpanGenerator getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const;
 
 		private:
 
@@ -103,6 +151,111 @@ namespace djv
 			int64_t _yEnd;
 	};
 
+	class ShapePolygon
+	{
+		public:
+
+			constexpr ShapePolygon(const std::vector<std::array<int64_t, 2>>& vertices);	// Pixels whose center is inside the closed polygon, with the even-odd rule
+
+			class Generator;
+
+			class SpanGenerator
+			{
+				public:
+
+					constexpr SpanGenerator(const std::vector<std::array<int64_t, 2>>& vertices, uint64_t clipWidth, uint64_t clipHeight);
+
+					constexpr bool getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd);
+
+				private:
+
+					struct Edge
+					{
+						int64_t yBegin;
+						int64_t yEnd;
+						int64_t numerator;	// The first pixel right of the edge on the current row is ceil(numerator / denominator)
+						int64_t step;
+						int64_t denominator;
+					};
+
+					constexpr SpanGenerator(const std::vector<std::array<int64_t, 2>>& vertices, int64_t clipLeft, int64_t clipTop, int64_t clipRight, int64_t clipBottom);
+
+					std::vector<Edge> _edges;	// Sorted by yBegin
+					std::vector<Edge> _activeEdges;
+					std::vector<int64_t> _crossings;
+					uint64_t _nextEdge, _crossing;
+					int64_t _clipLeft, _clipRight, _row, _rowEnd, _y;
+
+				friend class Generator;
+			};
+
+			class Generator
+			{
+				public:
+
+					constexpr Generator(const std::vector<std::array<int64_t, 2>>& vertices);
+
+					constexpr bool getNextPixel(int64_t& x, int64_t& y);
+
+				private:
+
+					SpanGenerator _spanGenerator;
+					int64_t _x, _xEnd, _y;
+			};
+
+			constexpr Generator getGenerator() const;
+			constexpr SpanGenerator getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const;
+
+		private:
+
+			std::vector<std::array<int64_t, 2>> _vertices;
+	};
+
+	class ShapeEllipse
+	{
+		public:
+
+			constexpr ShapeEllipse(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY);	// Filled, same pixels as ShapeDisc when both radii are equal
+
+			class Generator
+			{
+				public:
+
+					constexpr Generator(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY);
+
+					constexpr bool getNextPixel(int64_t& x, int64_t& y);
+
+				private:
+
+					int64_t _cx, _cy, _rxSq, _rySq;
+					int64_t _x, _xEnd, _y, _yNext, _yEnd;
+			};
+
+			class SpanGenerator
+			{
+				public:
+
+					constexpr SpanGenerator(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY, uint64_t clipWidth, uint64_t clipHeight);
+
+					constexpr bool getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd);
+
+				private:
+
+					int64_t _cx, _cy, _rxSq, _rySq;
+					int64_t _y, _yEnd, _clipWidth;
+			};
+
+			constexpr Generator getGenerator() const;
+			constexpr SpanGenerator getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const;
+
+		private:
+
+			int64_t _xCenter;
+			int64_t _yCenter;
+			uint64_t _radiusX;
+			uint64_t _radiusY;
+	};
+
 	class ShapeFilledRect : public ShapeThickRect
 	{
 		public:
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	enum class FileBackend
+	{
+		Stdio,		// std::FILE with a large stdio buffer
+		Buffered,	// Large user-space buffer, sequential readahead hint and positional writes
+		Direct		// Same as Buffered but bypasses the page cache with O_DIRECT when the file system allows it
+	};
+
+	class MemoryIStream
+	{
+		public:
+
+			MemoryIStream(const uint8_t* data, uint64_t size);	// The data is not copied and must outlive the stream
+			MemoryIStream(const MemoryIStream& stream) = delete;
+			MemoryIStream(MemoryIStream&& stream) = delete;
+
+			MemoryIStream& operator=(const MemoryIStream& stream) = delete;
+			MemoryIStream& operator=(MemoryIStream&& stream) = delete;
+
+			dsk::IStream* getStream();
+			uint64_t getPosition() const;
+
+			~MemoryIStream();
+
+		private:
+
+			static uint64_t _read(void* handle, uint8_t* data, uint64_t size);
+			static bool _eof(void* handle);
+
+			const uint8_t* _data;
+			uint64_t _size;
+			uint64_t _position;
+			dsk::IStream* _stream;
+	};
+
+	class MemoryOStream
+	{
+		public:
+
+			MemoryOStream(std::vector<uint8_t>& buffer);	// Written data is appended to the buffer
+			MemoryOStream(const MemoryOStream& stream) = delete;
+			MemoryOStream(MemoryOStream&& stream) = delete;
+
+			MemoryOStream& operator=(const MemoryOStream& stream) = delete;
+			MemoryOStream& operator=(MemoryOStream&& stream) = delete;
+
+			dsk::OStream* getStream();
+
+			~MemoryOStream();	// Flushes the stream
+
+		private:
+
+			static uint64_t _write(void* handle, const uint8_t* data, uint64_t size);
+
+			std::vector<uint8_t>* _buffer;
+			dsk::OStream* _stream;
+	};
+
+	class FileIStream
+	{
+		public:
+
+			FileIStream(const std::filesystem::path& path, FileBackend backend = FileBackend::Buffered);
+			FileIStream(const FileIStream& stream) = delete;
+			FileIStream(FileIStream&& stream) = delete;
+
+			FileIStream& operator=(const FileIStream& stream) = delete;
+			FileIStream& operator=(FileIStream&& stream) = delete;
+
+			dsk::IStream* getStream();
+			const ruc::Status& getStatus() const;
+
+			~FileIStream();
+
+		private:
+
+			static uint64_t _read(void* handle, uint8_t* data, uint64_t size);
+			static bool _eof(void* handle);
+
+			bool _refill();
+
+
+			static constexpr uint64_t _bufferSize = 1 << 22;
+			static constexpr uint64_t _alignment = 4096;
+
+
+			ruc::Status _status;
+			FileBackend _backend;
+			std::FILE* _file;
+			int _descriptor;
+
+			uint8_t* _buffer;
+			uint64_t _bufferPos;
+			uint64_t _bufferEnd;
+			bool _endOfFile;
+
+			dsk::IStream* _stream;
+	};
+
+	class FileOStream
+	{
+		public:
+
+			FileOStream(const std::filesystem::path& path, FileBackend backend = FileBackend::Buffered);
+			FileOStream(const FileOStream& stream) = delete;
+			FileOStream(FileOStream&& stream) = delete;
+
+			FileOStream& operator=(const FileOStream& stream) = delete;
+			FileOStream& operator=(FileOStream&& stream) = delete;
+
+			dsk::OStream* getStream();
+			void close();	// Flushes every pending byte to the file, the status tells whether everything was written
+			const ruc::Status& getStatus() const;
+
+			~FileOStream();
+
+		private:
+
+			static uint64_t _write(void* handle, const uint8_t* data, uint64_t size);
+
+			bool _writeBuffer(const uint8_t* data, uint64_t size);
+
+
+			static constexpr uint64_t _bufferSize = 1 << 22;
+			static constexpr uint64_t _alignment = 4096;
+
+
+			ruc::Status _status;
+			FileBackend _backend;
+			std::FILE* _file;
+			int _descriptor;
+
+			uint8_t* _buffer;
+			uint64_t _bufferEnd;
+			uint64_t _fileOffset;
+
+			dsk::OStream* _stream;
+	};
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreTypes.hpp>
+
+namespace djv
+{
+	namespace fmt
+	{
+		namespace y4m
+		{
+			enum class ChromaFormat
+			{
+				Mono,
+				Yuv420,
+				Yuv422,
+				Yuv444
+			};
+
+			enum class ColorMatrix
+			{
+				Bt601,
+				Bt709
+			};
+
+			struct Header
+			{
+				uint32_t width;
+				uint32_t height;
+				ChromaFormat chromaFormat;
+				bool fullRange;
+				uint32_t frameRateNumerator;
+				uint32_t frameRateDenominator;
+			};
+		}
+
+		class Y4mIStream
+		{
+			public:
+
+				Y4mIStream(dsk::IStream* stream);
+				Y4mIStream(const Y4mIStream& stream) = delete;
+				Y4mIStream(Y4mIStream&& stream) = delete;
+
+				Y4mIStream& operator=(const Y4mIStream& stream) = delete;
+				Y4mIStream& operator=(Y4mIStream&& stream) = delete;
+
+				void readHeader(y4m::Header& header);	// For Y4M streams
+				void setHeader(const y4m::Header& header);	// For raw planar YUV streams, which have no header
+
+				bool readFrame();	// Reads the next frame in the internal planes, returns false at the end of the stream or on error
+				bool readFrame(uint8_t* y, uint8_t* u, uint8_t* v);	// Reads the next frame directly in the given planes
+
+				const y4m::Header& getHeader() const;
+				const uint8_t* getPlane(uint8_t index) const;
+				uint32_t getPlaneWidth(uint8_t index) const;
+				uint32_t getPlaneHeight(uint8_t index) const;
+				uint8_t getPlaneCount() const;
+				const ruc::Status& getStatus() const;
+
+				~Y4mIStream() = default;
+
+			private:
+
+				bool _readToken(std::string& token, uint8_t& separator);
+				bool _readFrameHeader();
+				void _setupPlanes();
+
+
+				dsk::IStream* _stream;
+				ruc::Status _status;
+
+				y4m::Header _header;
+				bool _raw;
+				uint8_t _chromaShiftX;
+				uint8_t _chromaShiftY;
+
+				std::vector<uint8_t> _planes[3];
+		};
+	}
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	template<CPixel TPixel>
+	constexpr DrawList<TPixel>::DrawList(uint64_t width, uint64_t height) :
+		_width(width),
+		_height(height),
+		_bandShift(0),
+		_colors(),
+		_bands(),
+		_spanCount(0)
+	{
+		assert(width != 0 && width <= UINT32_MAX);
+		assert(height != 0 && height <= UINT32_MAX);
+
+		const uint64_t rowBytes = _width * sizeof(TPixel);
+		if (rowBytes < _bandBytes)
+		{
+			_bandShift = std::bit_width(_bandBytes / rowBytes) - 1;
+		}
+
+		_bands.resize(((_height - 1) >> _bandShift) + 1);
+	}
+
+	template<CPixel TPixel>
+	template<CSpanShape TShape>
+	constexpr void DrawList<TPixel>::add(const TShape& shape, const TPixel& color)
+	{
+		typename TShape::SpanGenerator generator = shape.getSpanGenerator(_width, _height);
+
+		// Spans are clipped by the generator, shapes entirely out of the image do not produce any and are dropped
+
+		int64_t y, xBegin, xEnd;
+		if (!generator.getNextSpan(y, xBegin, xEnd))
+		{
+			return;
+		}
+
+		const uint32_t colorIndex = _colors.size();
+		_colors.push_back(color);
+
+		do
+		{
+			_bands[y >> _bandShift].push_back({ static_cast<uint32_t>(y), static_cast<uint32_t>(xBegin), static_cast<uint32_t>(xEnd), colorIndex });
+			++_spanCount;
+		} while (generator.getNextSpan(y, xBegin, xEnd));
+	}
+
+	template<CPixel TPixel>
+	constexpr void DrawList<TPixel>::clear()
+	{
+		_colors.clear();
+		for (std::vector<Span>& band : _bands)
+		{
+			band.clear();
+		}
+		_spanCount = 0;
+	}
+
+	template<CPixel TPixel>
+	constexpr uint64_t DrawList<TPixel>::getWidth() const
+	{
+		return _width;
+	}
+
+	template<CPixel TPixel>
+	constexpr uint64_t DrawList<TPixel>::getHeight() const
+	{
+		return _height;
+	}
+
+	template<CPixel TPixel>
+	constexpr uint64_t DrawList<TPixel>::getShapeCount() const
+	{
+		return _colors.size();
+	}
+
+	template<CPixel TPixel>
+	constexpr uint64_t DrawList<TPixel>::getSpanCount() const
+	{
+		return _spanCount;
+	}
+}
@@ -52,6 +52,566 @@ namespace djv
 				to.set(i, from[i]);
 			}
 		}
+
+		constexpr void cubicWeights(float t, float* weights)
+		{
+			weights[0] = ((-0.5f * t + 1.f) * t - 0.5f) * t;
+			weights[1] = (1.5f * t - 2.5f) * t * t + 1.f;
+			weights[2] = ((-1.5f * t + 2.f) * t + 0.5f) * t;
+			weights[3] = (0.5f * t - 0.5f) * t * t;
+		}
+
+		constexpr void restrictWarpInterval(double p, double q, int64_t& first, int64_t& last)
+		{
+			// Keeps the i in [first, last) such that p + q * i >= 0
+
+			if (q == 0.0)
+			{
+				if (p < 0.0)
+				{
+					last = first;
+				}
+			}
+			else if (q > 0.0)
+			{
+				first = std::max<int64_t>(first, std::clamp<double>(std::ceil(-p / q), first, last));
+			}
+			else
+			{
+				last = std::min<int64_t>(last, std::clamp<double>(std::floor(-p / q) + 1.0, first, last));
+			}
+		}
+
+		template<CPixel TPixel>
+		static constexpr uint64_t transposeKernelSize = (sizeof(TPixel) >= 16) ? 4 : 8;
+
+		constexpr uint64_t transposeTileBytes = 16384;	// Source and destination tiles both stay in L1
+
+		template<CPixel TPixel>
+		constexpr void transposeKernel(const TPixel* source, int64_t sourceStride, TPixel* destination, int64_t destinationStride)
+		{
+			constexpr int64_t n = transposeKernelSize<TPixel>;
+
+			// 1-byte pixels: 8x8 transpose in eight 64-bit words, swapping 4x4, then 2x2, then 1x1 sub-blocks
+
+			if constexpr (sizeof(TPixel) == 1 && std::endian::native == std::endian::little)
+			{
+				uint64_t rows[8];
+				for (int64_t r = 0; r < 8; ++r)
+				{
+					std::memcpy(rows + r, &source[r * sourceStride][0], 8);
+				}
+
+				constexpr uint64_t masks[3] = { 0x00000000FFFFFFFFull, 0x0000FFFF0000FFFFull, 0x00FF00FF00FF00FFull };
+				for (uint64_t s = 0, shift = 32; s < 3; ++s, shift /= 2)
+				{
+					for (int64_t r = 0; r < 8; ++r)
+					{
+						if ((r & shift / 8) == 0)
+						{
+							const uint64_t a = rows[r];
+							const uint64_t b = rows[r + shift / 8];
+							rows[r] = (a & masks[s]) | ((b & masks[s]) << shift);
+							rows[r + shift / 8] = ((a >> shift) & masks[s]) | (b & ~masks[s]);
+						}
+					}
+				}
+
+				for (int64_t r = 0; r < 8; ++r)
+				{
+					std::memcpy(&destination[r * destinationStride][0], rows + r, 8);
+				}
+			}
+
+			// Other sizes: fully unrolled n x n block, each destination row is written contiguously
+
+			else
+			{
+				for (int64_t c = 0; c < n; ++c)
+				{
+					TPixel* itDestination = destination + c * destinationStride;
+					for (int64_t r = 0; r < n; ++r)
+					{
+						itDestination[r] = source[r * sourceStride + c];
+					}
+				}
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void transposeBlock(const TPixel* source, int64_t sourceStride, TPixel* destination, int64_t destinationStride, int64_t width, int64_t height)
+		{
+			constexpr int64_t n = transposeKernelSize<TPixel>;
+
+			// Split the largest dimension until the block fits in cache
+
+			if (width * height * sizeof(TPixel) > transposeTileBytes && std::max(width, height) >= 2 * n)
+			{
+				if (width >= height)
+				{
+					const int64_t half = (width / 2) / n * n;
+					transposeBlock(source, sourceStride, destination, destinationStride, half, height);
+					transposeBlock(source + half, sourceStride, destination + half * destinationStride, destinationStride, width - half, height);
+				}
+				else
+				{
+					const int64_t half = (height / 2) / n * n;
+					transposeBlock(source, sourceStride, destination, destinationStride, width, half);
+					transposeBlock(source + half * sourceStride, sourceStride, destination + half, destinationStride, width, height - half);
+				}
+
+				return;
+			}
+
+			// Full kernels, then the remaining columns and rows one pixel at a time
+
+			const int64_t kernelWidth = width / n * n;
+			const int64_t kernelHeight = height / n * n;
+
+			for (int64_t j = 0; j < kernelHeight; j += n)
+			{
+				for (int64_t i = 0; i < kernelWidth; i += n)
+				{
+					transposeKernel(source + j * sourceStride + i, sourceStride, destination + i * destinationStride + j, destinationStride);
+				}
+
+				for (int64_t i = kernelWidth; i < width; ++i)
+				{
+					for (int64_t r = j; r < j + n; ++r)
+					{
+						destination[i * destinationStride + r] = source[r * sourceStride + i];
+					}
+				}
+			}
+
+			for (int64_t j = kernelHeight; j < height; ++j)
+			{
+				for (int64_t i = 0; i < width; ++i)
+				{
+					destination[i * destinationStride + j] = source[j * sourceStride + i];
+				}
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void transposeSwap(TPixel* a, TPixel* b, uint64_t stride, uint64_t width, uint64_t height)
+		{
+			// Swaps the height x width block a with the transpose of the width x height block b
+
+			if (width * height * sizeof(TPixel) > transposeTileBytes / 2 && std::max(width, height) >= 2)
+			{
+				if (width >= height)
+				{
+					const uint64_t half = width / 2;
+					transposeSwap(a, b, stride, half, height);
+					transposeSwap(a + half, b + half * stride, stride, width - half, height);
+				}
+				else
+				{
+					const uint64_t half = height / 2;
+					transposeSwap(a, b, stride, width, half);
+					transposeSwap(a + half * stride, b + half, stride, width, height - half);
+				}
+
+				return;
+			}
+
+			for (uint64_t j = 0; j < height; ++j)
+			{
+				for (uint64_t i = 0; i < width; ++i)
+				{
+					std::swap(a[j * stride + i], b[i * stride + j]);
+				}
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void reversePixels(TPixel* first, TPixel* last)
+		{
+			// Pixels of 1, 2 or 4 bytes are reversed 8 bytes at a time by shuffling bytes within a 64-bit word
+
+			if constexpr ((sizeof(TPixel) == 1 || sizeof(TPixel) == 2 || sizeof(TPixel) == 4) && std::endian::native == std::endian::little)
+			{
+				constexpr int64_t n = 8 / sizeof(TPixel);
+
+				for (; last - first >= 2 * n; first += n, last -= n)
+				{
+					uint64_t words[2];
+					std::memcpy(words, &first[0][0], 8);
+					std::memcpy(words + 1, &last[-n][0], 8);
+
+					for (uint64_t& word : words)
+					{
+						if constexpr (sizeof(TPixel) == 1)
+						{
+							word = std::byteswap(word);
+						}
+						else if constexpr (sizeof(TPixel) == 2)
+						{
+							word = std::rotl(word, 32);
+							word = ((word & 0x0000FFFF0000FFFFull) << 16) | ((word >> 16) & 0x0000FFFF0000FFFFull);
+						}
+						else
+						{
+							word = std::rotl(word, 32);
+						}
+					}
+
+					std::memcpy(&first[0][0], words + 1, 8);
+					std::memcpy(&last[-n][0], words, 8);
+				}
+			}
+
+			std::reverse(first, last);
+		}
+
+		template<CPixel TPixel>
+		constexpr void transposeSquare(TPixel* pixels, uint64_t stride, uint64_t size)
+		{
+			// Transpose both diagonal quadrants in place, and swap the two others
+
+			if (size * size * sizeof(TPixel) > transposeTileBytes / 2 && size >= 2)
+			{
+				const uint64_t half = size / 2;
+				transposeSquare(pixels, stride, half);
+				transposeSquare(pixels + half * stride + half, stride, size - half);
+				transposeSwap(pixels + half, pixels + half * stride, stride, size - half, half);
+
+				return;
+			}
+
+			for (uint64_t j = 0; j < size; ++j)
+			{
+				for (uint64_t i = j + 1; i < size; ++i)
+				{
+					std::swap(pixels[j * stride + i], pixels[i * stride + j]);
+				}
+			}
+		}
+
+		template<scp::BorderBehaviour BBehaviour>
+		constexpr int64_t borderIndex(int64_t i, int64_t size)
+		{
+			// Same rules as Image::getOutOfBound, -1 stands for the zero color
+
+			if (i >= 0 && i < size)
+			{
+				return i;
+			}
+			else if constexpr (BBehaviour == scp::BorderBehaviour::Zero)
+			{
+				return -1;
+			}
+			else if constexpr (BBehaviour == scp::BorderBehaviour::Continuous)
+			{
+				return (i < 0) ? 0 : size - 1;
+			}
+			else
+			{
+				i %= size;
+				return (i < 0) ? i + size : i;
+			}
+		}
+
+		constexpr uint64_t blurStripSize = 64;	// Components per row of a strip
+
+		template<scp::BorderBehaviour BBehaviour, typename TComponent, typename TStripComponent>
+		constexpr void gatherStrip(const TComponent* source, const TComponent* zeroRow, uint64_t rowSize, int64_t height, int64_t padding, uint64_t size, TStripComponent* strip)
+		{
+			// Copies size components of each row, from padding rows above the image to padding rows below it
+
+			for (int64_t j = -padding; j < height + padding; ++j, strip += blurStripSize)
+			{
+				const int64_t y = borderIndex<BBehaviour>(j, height);
+				std::copy_n((y < 0) ? zeroRow : source + y * rowSize, size, strip);
+			}
+		}
+
+		// Unsigned components of 8 and 16 bits are blurred with integers only: 15-bit fixed point weights, 32-bit accumulators
+
+		template<typename TComponent>
+		static constexpr bool isFixedPointBlur = std::unsigned_integral<TComponent> && sizeof(TComponent) <= 2;
+
+		constexpr uint8_t blurWeightBits = 15;
+
+		template<typename TWeight>
+		constexpr void quantizeBlurWeights(const float* weights, uint64_t count, TWeight* quantized)
+		{
+			if constexpr (std::floating_point<TWeight>)
+			{
+				std::copy_n(weights, count, quantized);
+			}
+			else
+			{
+				// The rounding error goes to the center weight, so that weights sum exactly to 1
+
+				int64_t sum = 0;
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					quantized[i] = std::round(weights[i] * (1 << blurWeightBits));
+					sum += quantized[i];
+				}
+				quantized[count / 2] += (1 << blurWeightBits) - sum;
+			}
+		}
+
+		template<typename TComponent, typename TAccumulator>
+		constexpr TComponent blurCast(TAccumulator value)
+		{
+			if constexpr (std::floating_point<TAccumulator>)
+			{
+				return static_cast<TComponent>(value);
+			}
+			else
+			{
+				return (value + (1 << (blurWeightBits - 1))) >> blurWeightBits;
+			}
+		}
+
+		template<typename TComponent>
+		constexpr uint64_t blurMeanCountLimit = uint64_t(1) << (32 - 8 * sizeof(TComponent));
+
+		template<typename TComponent>
+		constexpr uint64_t blurMeanMultiplier(uint64_t count)
+		{
+			// floor(n / count) is n * multiplier >> shift for every n < 2^(8 * sizeof(TComponent)) * count, as long as count^2 is
+			// less than 2^(shift - 8 * sizeof(TComponent))
+
+			constexpr uint8_t shift = 64 - 8 * sizeof(TComponent);
+			assert(count < blurMeanCountLimit<TComponent>);
+
+			return ((uint64_t(1) << shift) + count - 1) / count;
+		}
+
+		template<typename TComponent, typename TSum>
+		constexpr TComponent blurMeanCast(TSum sum, uint64_t count, uint64_t multiplier)
+		{
+			if constexpr (std::floating_point<TSum>)
+			{
+				return static_cast<TComponent>(sum / count);
+			}
+			else if constexpr (std::same_as<TSum, uint64_t>)
+			{
+				return (sum + count / 2) / count;	// Only for counts past blurMeanCountLimit, where the multiplication would overflow
+			}
+			else
+			{
+				return ((sum + count / 2) * multiplier) >> (64 - 8 * sizeof(TComponent));
+			}
+		}
+
+		template<typename TComponent, typename TSum>
+		constexpr TComponent integralMeanCast(TSum sum, uint64_t count)
+		{
+			if constexpr (std::unsigned_integral<TSum>)
+			{
+				return (sum + count / 2) / count;
+			}
+			else
+			{
+				return static_cast<TComponent>(sum / static_cast<double>(count));
+			}
+		}
+
+		template<CPixel TPixel, typename TWeight, typename TAccumulator>
+		constexpr void convolveLine(const TPixel* source, TPixel* destination, uint64_t size, const TWeight* weights, uint64_t weightCount, TAccumulator* accumulator)
+		{
+			using TComponent = typename TPixel::ComponentType;
+			constexpr uint8_t componentCount = TPixel::componentCount;
+
+			// Source holds the size + weightCount - 1 pixels covered by the kernel. Each weight is applied to the whole line at
+			// once, so the inner loop is a plain multiply-accumulate over contiguous components
+
+			const uint64_t lineSize = size * componentCount;
+			const TComponent* itSource = &source[0][0];
+
+			std::fill_n(accumulator, lineSize, TAccumulator(0));
+			for (uint64_t p = 0; p < weightCount; ++p, itSource += componentCount)
+			{
+				const TWeight weight = weights[p];
+				for (uint64_t n = 0; n < lineSize; ++n)
+				{
+					accumulator[n] += itSource[n] * weight;
+				}
+			}
+
+			TComponent* it = &destination[0][0];
+			for (uint64_t n = 0; n < lineSize; ++n)
+			{
+				it[n] = blurCast<TComponent>(accumulator[n]);
+			}
+		}
+
+		constexpr void boxBlurRadii(float sigma, uint64_t* radii)
+		{
+			// Three box filters of widths w and w + 2 whose variances sum to sigma^2, see Kovesi, "Fast almost-gaussian filtering"
+
+			const float variance = sigma * sigma;
+			int64_t width = std::sqrt(4.f * variance + 1.f);
+			width -= (width % 2 == 0);
+
+			const int64_t narrowCount = std::clamp<float>(std::round((12.f * variance - 3 * width * width - 12 * width - 9) / (-4.f * width - 4.f)), 0.f, 3.f);
+			for (int64_t i = 0; i < 3; ++i)
+			{
+				radii[i] = ((i < narrowCount) ? width : width + 2) / 2;
+			}
+		}
+
+		struct RecursiveGaussian
+		{
+			float b;
+			float c1;
+			float c2;
+			float c3;
+		};
+
+		constexpr std::array<double, 4> youngVanVlietCoefficients(double q)
+		{
+			// Young and van Vliet, "Recursive implementation of the Gaussian filter", 1995. Returns b, c1, c2, c3
+
+			const double qSq = q * q;
+			const double qCube = qSq * q;
+
+			const double b0 = 1.57825 + 2.44413 * q + 1.4281 * qSq + 0.422205 * qCube;
+			const double b1 = 2.44413 * q + 2.85619 * qSq + 1.26661 * qCube;
+			const double b2 = -1.4281 * qSq - 1.26661 * qCube;
+			const double b3 = 0.422205 * qCube;
+
+			return { 1.0 - (b1 + b2 + b3) / b0, b1 / b0, b2 / b0, b3 / b0 };
+		}
+
+		constexpr RecursiveGaussian recursiveGaussianCoefficients(float sigma)
+		{
+			assert(sigma > 0.f);
+
+			// The q given in the paper yields a standard deviation about 10% too large, q is instead chosen so that the variance of
+			// the causal and anti-causal passes, 2 * (m^2 + m + (2 * c2 + 6 * c3) / b) with m = (c1 + 2 * c2 + 3 * c3) / b, is sigma^2
+
+			double qMin = 0.0;
+			double qMax = 2.0 * sigma + 2.0;
+			for (uint8_t i = 0; i < 48; ++i)
+			{
+				const double q = (qMin + qMax) / 2.0;
+				const auto [b, c1, c2, c3] = youngVanVlietCoefficients(q);
+				const double m = (c1 + 2.0 * c2 + 3.0 * c3) / b;
+				const double variance = 2.0 * (m * m + m + (2.0 * c2 + 6.0 * c3) / b);
+
+				(variance < sigma * sigma ? qMin : qMax) = q;
+			}
+
+			const auto [b, c1, c2, c3] = youngVanVlietCoefficients((qMin + qMax) / 2.0);
+			return { static_cast<float>(b), static_cast<float>(c1), static_cast<float>(c2), static_cast<float>(c3) };
+		}
+
+		constexpr void recursiveGaussianLine(float* line, uint64_t count, uint64_t stride, const RecursiveGaussian& coefs)
+		{
+			// A causal then an anti-causal pass, over count samples of stride floats. The first and last three samples are
+			// padding and are used as is to start each pass
+
+			assert(count >= 6);
+
+			for (float* it = line + 3 * stride; it != line + count * stride; it += stride)
+			{
+				for (uint64_t k = 0; k < stride; ++k)
+				{
+					it[k] = coefs.b * it[k] + coefs.c1 * it[k - stride] + coefs.c2 * it[k - 2 * stride] + coefs.c3 * it[k - 3 * stride];
+				}
+			}
+
+			for (float* it = line + (count - 4) * stride; it != line - stride; it -= stride)
+			{
+				for (uint64_t k = 0; k < stride; ++k)
+				{
+					it[k] = coefs.b * it[k] + coefs.c1 * it[k + stride] + coefs.c2 * it[k + 2 * stride] + coefs.c3 * it[k + 3 * stride];
+				}
+			}
+		}
+
+		constexpr uint32_t blendScale(uint32_t word, uint32_t factor)
+		{
+			// Each byte of word times factor / 255, rounded, computed on two 16-bit lanes at a time
+
+			uint32_t rb = (word & 0x00FF00FF) * factor + 0x00800080;
+			uint32_t ga = ((word >> 8) & 0x00FF00FF) * factor + 0x00800080;
+			rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+			ga = (ga + ((ga >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+			return rb | ga;
+		}
+
+		template<CPixel TPixel>
+		constexpr void blendRow(TPixel* destination, const TPixel* source, uint64_t count, BlendMode mode, float alpha)
+		{
+			using TComponent = typename TPixel::ComponentType;
+			constexpr uint8_t componentCount = TPixel::componentCount;
+			static_assert(componentCount == 4 && (std::same_as<TComponent, uint8_t> || std::same_as<TComponent, float>));
+
+			// u8: one pixel per 32-bit word, the source is scaled by alpha and the destination by 1 - source alpha in two multiplies each
+
+			if constexpr (std::same_as<TComponent, uint8_t>)
+			{
+				constexpr uint32_t alphaShift = (std::endian::native == std::endian::little) ? 24 : 0;
+				const uint32_t factor = std::clamp<float>(std::round(alpha * 255.f), 0.f, 255.f);
+
+				for (uint64_t i = 0; i < count; ++i)
+				{
+					uint32_t s, d;
+					std::memcpy(&s, &source[i][0], 4);
+					std::memcpy(&d, &destination[i][0], 4);
+
+					if (factor != 255)
+					{
+						s = blendScale(s, factor);
+					}
+
+					if (mode == BlendMode::Over)
+					{
+						d = s + blendScale(d, 255 - ((s >> alphaShift) & 0xFF));
+					}
+					else
+					{
+						const uint32_t sum = (s & 0x7F7F7F7F) + (d & 0x7F7F7F7F);
+						const uint32_t carry = ((s & d) | ((s ^ d) & sum)) & 0x80808080;
+						d = (sum ^ ((s ^ d) & 0x80808080)) | ((carry >> 7) * 0xFF);
+					}
+
+					std::memcpy(&destination[i][0], &d, 4);
+				}
+			}
+
+			// f32: components are in [-1, 1], that is 2c - 1 for c in [0, 1]
+
+			else
+			{
+				const float* itSource = &source[0][0];
+				float* it = &destination[0][0];
+
+				for (uint64_t i = 0; i < count; ++i, itSource += componentCount, it += componentCount)
+				{
+					float s[componentCount];
+					for (uint8_t k = 0; k < componentCount; ++k)
+					{
+						s[k] = alpha * (itSource[k] + 1.f) - 1.f;
+					}
+
+					if (mode == BlendMode::Over)
+					{
+						const float transparency = (1.f - s[3]) * 0.5f;
+						for (uint8_t k = 0; k < componentCount; ++k)
+						{
+							it[k] = s[k] + (it[k] + 1.f) * transparency;
+						}
+					}
+					else
+					{
+						for (uint8_t k = 0; k < componentCount; ++k)
+						{
+							it[k] = std::min(s[k] + it[k] + 1.f, 1.f);
+						}
+					}
+				}
+			}
+		}
 	}
 
 	template<CPixel TPixel>
@@ -84,37 +644,37 @@ namespace djv
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const std::filesystem::path& path) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(const std::filesystem::path& path, FileBackend backend) : Image<TPixel>()
 	{
-		createFromFile(path);
+		createFromFile(path, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const std::filesystem::path& path, const uint8_t* swizzling) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend) : Image<TPixel>()
 	{
-		createFromFile(path, swizzling);
+		createFromFile(path, swizzling, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend) : Image<TPixel>()
 	{
-		createFromFile(path, swizzling);
+		createFromFile(path, swizzling, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const dsk::IStream* stream, ImageFormat format) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(dsk::IStream* stream, ImageFormat format) : Image<TPixel>()
 	{
 		createFromStream(stream, format);
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling) : Image<TPixel>()
 	{
 		createFromStream(stream, format, swizzling);
 	}
 
 	template<CPixel TPixel>
-	constexpr Image<TPixel>::Image(const dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling) : Image<TPixel>()
+	constexpr Image<TPixel>::Image(dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling) : Image<TPixel>()
 	{
 		createFromStream(stream, format, swizzling);
 	}
@@ -153,6 +713,12 @@ namespace djv
 		}
 	}
 
+	template<CPixel TPixel>
+	constexpr Image<TPixel>::Image(const Image<TPixel>& image, uint64_t width, uint64_t height, ResamplingFilter filter) : Image<TPixel>()
+	{
+		createFromResize(image, width, height, filter);
+	}
+
 	template<CPixel TPixel>
 	constexpr Image<TPixel>::Image(const Image<TPixel>& image, uint64_t x, uint64_t y, uint64_t width, uint64_t height) : Image<TPixel>()
 	{
@@ -177,14 +743,35 @@ namespace djv
 		assert(width != 0);
 		assert(height != 0);
 
-		Image<TPixel>* image = new Image<TPixel>();
+		Image<TPixel>* image = new Image<TPixel>();
+
+		image->_width = width;
+		image->_height = height;
+		image->_pixels = memory;
+		image->_owner = false;
+
+		return image;
+	}
+
+	template<CPixel TPixel>
+	constexpr Image<TPixel>* Image<TPixel>::constructAroundMemory(void* djvFile, uint64_t size)
+	{
+		assert(djvFile);
+
+		if (size < sizeof(fmt::native::Header))
+		{
+			return nullptr;
+		}
 
-		image._width = width;
-		image._height = height;
-		image._pixels = memory;
-		image._owner = false;
+		fmt::native::Header header;
+		std::copy_n(reinterpret_cast<const uint8_t*>(djvFile), sizeof(fmt::native::Header), reinterpret_cast<uint8_t*>(&header));
 
-		return image;
+		if (!fmt::native::isCompatible<TPixel>(header) || header.dataOffset > size || header.stride * header.height > size - header.dataOffset)
+		{
+			return nullptr;
+		}
+
+		return constructAroundMemory(header.width, header.height, reinterpret_cast<TPixel*>(reinterpret_cast<uint8_t*>(djvFile) + header.dataOffset));
 	}
 
 	template<CPixel TPixel>
@@ -202,24 +789,6 @@ namespace djv
 	}
 
 
-	namespace _djv
-	{
-		inline uint64_t read(void* handle, uint8_t* data, uint64_t size)
-		{
-			return std::fread(data, 1, size, reinterpret_cast<std::FILE*>(handle));
-		}
-
-		inline bool eof(void* handle)
-		{
-			return std::feof(reinterpret_cast<std::FILE*>(handle));
-		}
-
-		inline uint64_t write(void* handle, const uint8_t* data, uint64_t size)
-		{
-			return std::fwrite(data, 1, size, reinterpret_cast<std::FILE*>(handle));
-		}
-	}
-
 	template<CPixel TPixel>
 	constexpr void Image<TPixel>::createNew(uint64_t width, uint64_t height)
 	{
@@ -248,45 +817,61 @@ namespace djv
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path)
+	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, FileBackend backend)
 	{
 		uint8_t swizzling[componentCount];
 		_djv::defaultLoadSwizzling<componentCount>(swizzling);
-		_createFromFile(path, swizzling);
+		_createFromFile(path, swizzling, nullptr, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend)
 	{
-		_createFromFile(path, swizzling);
+		_createFromFile(path, swizzling, nullptr, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling)
+	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend)
 	{
 		assert(swizzling.size() == componentCount);
-		_createFromFile(path, swizzling.begin());
+		_createFromFile(path, swizzling.begin(), nullptr, backend);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, uint64_t width, uint64_t height, scp::InterpolationMethod method, FileBackend backend)
+	{
+		createFromFile(path, width, height, _djv::toResamplingFilter(method), backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromStream(const dsk::IStream* stream, ImageFormat format)
+	constexpr void Image<TPixel>::createFromFile(const std::filesystem::path& path, uint64_t width, uint64_t height, ResamplingFilter filter, FileBackend backend)
 	{
 		uint8_t swizzling[componentCount];
 		_djv::defaultLoadSwizzling<componentCount>(swizzling);
-		_createFromStream(stream, format, swizzling);
+
+		_djv::StreamResampler<TPixel> resampler(width, height, filter);
+		_createFromFile(path, swizzling, &resampler, backend);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::createFromStream(dsk::IStream* stream, ImageFormat format)
+	{
+		uint8_t swizzling[componentCount];
+		_djv::defaultLoadSwizzling<componentCount>(swizzling);
+		_createFromStream(stream, format, swizzling, nullptr);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromStream(const dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling)
 	{
-		_createFromStream(stream, format, swizzling);
+		_createFromStream(stream, format, swizzling, nullptr);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::createFromStream(const dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling)
+	constexpr void Image<TPixel>::createFromStream(dsk::IStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling)
 	{
 		assert(swizzling.size() == componentCount);
-		_createFromStream(stream, format, swizzling.begin());
+		_createFromStream(stream, format, swizzling.begin(), nullptr);
 	}
 
 	template<CPixel TPixel>
@@ -323,24 +908,31 @@ namespace djv
 			_copyFrom(image);
 		}
 
-		// Downsample
+		// Downsample, averaging each block unless nearest neighbour was asked for
 
 		else if (image._width >= _width && image._width % _width == 0 && image._height >= _height && image._height % _height == 0)
 		{
-			const uint64_t xStep = image._width / _width;
-			const uint64_t yStep = image._height / _height - 1;
+			if constexpr (IMethod == scp::InterpolationMethod::Nearest)
+			{
+				const uint64_t xStep = image._width / _width;
+				const uint64_t yStep = image._height / _height - 1;
 
-			TPixel* it = _pixels;
-			const TPixel* itImage = image._pixels;
+				TPixel* it = _pixels;
+				const TPixel* itImage = image._pixels;
 
-			for (uint64_t i = 0; i < _height; ++i)
-			{
-				for (uint64_t j = 0; j < _width; ++j, ++it, itImage += xStep)
+				for (uint64_t i = 0; i < _height; ++i)
 				{
-					*it = *itImage;
-				}
+					for (uint64_t j = 0; j < _width; ++j, ++it, itImage += xStep)
+					{
+						*it = *itImage;
+					}
 
-				itImage += yStep * image._width;
+					itImage += yStep * image._width;
+				}
+			}
+			else
+			{
+				_djv::downsampleBox(image._pixels, image._width, _pixels, _width, _height, image._width / _width, image._height / _height);
 			}
 		}
 
@@ -426,13 +1018,26 @@ namespace djv
 
 			// Pure resize (with interpolation...)
 
-			scp::Tensor<TPixel>* imageTensor = scp::Tensor<TPixel>::createAroundMemory({ image._height, image._width }, const_cast<TPixel*>(image._pixels));
-			scp::Tensor<TPixel>* tensor = scp::Tensor<TPixel>::createAroundMemory({ _height, _width }, _pixels);
+			_resample(image, _djv::toResamplingFilter(IMethod));
+		}
+	}
 
-			tensor->resize<float, IMethod>(*imageTensor);
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::createFromResize(const Image<TPixel>& image, uint64_t width, uint64_t height, ResamplingFilter filter)
+	{
+		createNew(width, height);
 
-			delete imageTensor;
-			delete tensor;
+		if (image._width == _width && image._height == _height)
+		{
+			_copyFrom(image);
+		}
+		else if (filter == ResamplingFilter::Box && image._width % _width == 0 && image._height % _height == 0)
+		{
+			_djv::downsampleBox(image._pixels, image._width, _pixels, _width, _height, image._width / _width, image._height / _height);
+		}
+		else
+		{
+			_resample(image, filter);
 		}
 	}
 
@@ -454,28 +1059,106 @@ namespace djv
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path) const
+	constexpr void Image<TPixel>::createFromTranspose(const Image<TPixel>& image)
+	{
+		assert(&image != this);
+
+		createNew(image._height, image._width);
+		_djv::transposeBlock(image._pixels, image._width, _pixels, _width, image._width, image._height);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::createFromYuv(const fmt::Y4mIStream& stream)
+	{
+		createFromYuv(stream, fmt::y4m::ColorMatrix::Bt601);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::createFromYuv(const fmt::Y4mIStream& stream, fmt::y4m::ColorMatrix matrix)
+	{
+		const fmt::y4m::Header& header = stream.getHeader();
+		createNew(header.width, header.height);
+
+		const std::array<int32_t, 6>& coefficients = _djv::yuvToRgbCoefficients[static_cast<uint8_t>(matrix)][header.fullRange];
+		const bool hasChroma = (stream.getPlaneCount() == 3);
+		const uint8_t shiftX = hasChroma && (stream.getPlaneWidth(1) != header.width);
+		const uint8_t shiftY = hasChroma && (stream.getPlaneHeight(1) != header.height);
+		const uint32_t chromaWidth = stream.getPlaneWidth(1);
+
+		constexpr uint8_t colorCount = (componentCount >= 3) ? 3 : 1;
+		constexpr uint8_t alphaIndex = colorCount;
+
+		// Chroma is upsampled and converted while the row is written, no intermediate RGB frame is stored
+
+		TPixel* it = _pixels;
+		for (uint64_t j = 0; j < _height; ++j)
+		{
+			const uint8_t* itY = stream.getPlane(0) + j * _width;
+			const uint8_t* itU = hasChroma ? stream.getPlane(1) + (j >> shiftY) * chromaWidth : nullptr;
+			const uint8_t* itV = hasChroma ? stream.getPlane(2) + (j >> shiftY) * chromaWidth : nullptr;
+
+			for (uint64_t i = 0; i < _width; ++i, ++it)
+			{
+				const int32_t y = (itY[i] - coefficients[0]) * coefficients[1] + (1 << 13);
+				const int32_t u = hasChroma ? itU[i >> shiftX] - 128 : 0;
+				const int32_t v = hasChroma ? itV[i >> shiftX] - 128 : 0;
+
+				int32_t rgb[3];
+				if constexpr (colorCount == 3)
+				{
+					rgb[0] = y + coefficients[2] * v;
+					rgb[1] = y - coefficients[3] * u - coefficients[4] * v;
+					rgb[2] = y + coefficients[5] * u;
+				}
+				else
+				{
+					rgb[0] = y;
+				}
+
+				for (uint8_t k = 0; k < colorCount; ++k)
+				{
+					const int32_t value = std::clamp(rgb[k] >> 14, 0, 255);
+					if constexpr (std::same_as<TComponent, uint8_t>)
+					{
+						(*it)[k] = value;
+					}
+					else
+					{
+						it->set(k, value * (2.f / 255.f) - 1.f);
+					}
+				}
+
+				for (uint8_t k = colorCount; k < componentCount; ++k)
+				{
+					(*it)[k] = (k == alphaIndex) ? colors::white<TComponent, componentCount>[k] : colors::black<TComponent, componentCount>[k];
+				}
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path, FileBackend backend) const
 	{
 		uint8_t swizzling[4];
 		_djv::defaultSaveSwizzling<componentCount>(swizzling);
-		_saveToFile(path, swizzling);
+		_saveToFile(path, swizzling, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path, const uint8_t* swizzling) const
+	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend) const
 	{
-		_saveToFile(path, swizzling);
+		_saveToFile(path, swizzling, backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling) const
+	constexpr void Image<TPixel>::saveToFile(const std::filesystem::path& path, const std::initializer_list<uint8_t>& swizzling, FileBackend backend) const
 	{
 		assert(swizzling.size() == 4);
-		_saveToFile(path, swizzling.begin());
+		_saveToFile(path, swizzling.begin(), backend);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToStream(const dsk::OStream* stream, ImageFormat format)
+	constexpr void Image<TPixel>::saveToStream(dsk::OStream* stream, ImageFormat format) const
 	{
 		uint8_t swizzling[4];
 		_djv::defaultSaveSwizzling<componentCount>(swizzling);
@@ -483,26 +1166,51 @@ namespace djv
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToStream(const dsk::OStream* stream, ImageFormat format, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::saveToStream(dsk::OStream* stream, ImageFormat format, const uint8_t* swizzling) const
 	{
 		_saveToStream(stream, format, swizzling);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::saveToStream(const dsk::OStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling)
+	constexpr void Image<TPixel>::saveToStream(dsk::OStream* stream, ImageFormat format, const std::initializer_list<uint8_t>& swizzling) const
 	{
 		assert(swizzling.size() == 4);
-		_saveToStream(stream, format, swizzling);
+		_saveToStream(stream, format, swizzling.begin());
 	}
 
 	template<CPixel TPixel>
 	constexpr void Image<TPixel>::transpose()
 	{
-		scp::Matrix<TPixel>* matrix = scp::Matrix<TPixel>::createAroundMemory(_height, _width, _pixels);
-		matrix->transpose();
-		delete matrix;
+		if (_width == _height)
+		{
+			_djv::transposeSquare(_pixels, _width, _width);
+		}
+		else
+		{
+			_transposeReplace(0, _width, 0, _height);
+		}
+	}
 
-		std::swap(_width, _height);
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::rotate90()
+	{
+		// Destination rows are the source columns, from the last one to the first
+
+		_transposeReplace(0, _width, (_width - 1) * _height, -static_cast<int64_t>(_height));
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::rotate180()
+	{
+		_djv::reversePixels(_pixels, _pixels + _width * _height);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::rotate270()
+	{
+		// Destination columns are the source rows, from the last one to the first
+
+		_transposeReplace((_height - 1) * _width, -static_cast<int64_t>(_width), 0, _height);
 	}
 
 	template<CPixel TPixel>
@@ -515,17 +1223,15 @@ namespace djv
 		}
 		else if (std::abs(angle - 0.5f * std::numbers::pi) < 1e-3)
 		{
-			transpose();
-			flip<true, false>();
+			rotate90();
 		}
 		else if (std::abs(angle - std::numbers::pi) < 1e-3)
 		{
-			flip<true, true>();
+			rotate180();
 		}
 		else if (std::abs(angle - 1.5f * std::numbers::pi) < 1e-3)
 		{
-			flip<true, false>();
-			transpose();
+			rotate270();
 		}
 		else
 		{
@@ -542,43 +1248,71 @@ namespace djv
 			const float Mx = std::max({ 0.f, -h * sa, w * ca, r * car });
 			const float My = std::max({ 0.f, h * ca, w * sa, r * sar });
 
-			scp::Tensor<TPixel>* tensor = scp::Tensor<TPixel>::createAroundMemory({ _height, _width }, _pixels);
+			const float matrix[6] = { ca, sa, mx * ca + my * sa, -sa, ca, my * ca - mx * sa };
+			_warp<IMethod, BBehaviour, false>(matrix, Mx - mx + 1, My - my + 1);
+		}
+	}
 
-			_width = Mx - mx + 1;
-			_height = My - my + 1;
+	template<CPixel TPixel>
+	template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::warpAffine(const std::array<float, 6>& matrix, uint64_t width, uint64_t height)
+	{
+		_warp<IMethod, BBehaviour, false>(matrix.data(), width, height);
+	}
 
-			TPixel* pixels = new TPixel[_width * _height];
-			TPixel* it = pixels;
+	template<CPixel TPixel>
+	template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::warpPerspective(const std::array<float, 9>& matrix, uint64_t width, uint64_t height)
+	{
+		_warp<IMethod, BBehaviour, true>(matrix.data(), width, height);
+	}
 
-			float indices[2];
-			for (uint64_t j = 0; j < _height; ++j)
-			{
-				for (uint64_t i = 0; i < _width; ++i, ++it)
-				{
-					indices[0] = (j + my) * ca - (i + mx) * sa;
-					indices[1] = (i + mx) * ca + (j + my) * sa;
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::remap(const RemapTable& table, Image<TPixel>& destination) const
+	{
+		assert(table._sourceWidth == _width);
+		assert(table._sourceHeight == _height);
+		assert(&destination != this);
 
-					if (indices[0] >= 0 && indices[0] < h && indices[1] >= 0 && indices[1] < w)
-					{
-						*it = tensor->getInterpolated<float, IMethod>(indices);
-					}
-					else if constexpr (BBehaviour == scp::BorderBehaviour::Zero)
-					{
-						*it = _zeroColor;
-					}
-					else
-					{
-						*it = tensor->getOutOfBound<BBehaviour>({ static_cast<int64_t>(indices[0]), static_cast<int64_t>(indices[1]) });
-					}
-				}
+		using TAccumulator = std::conditional_t<std::floating_point<TComponent>, float, std::conditional_t<sizeof(TComponent) == 1, int32_t, int64_t>>;
+
+		destination.createNew(table._width, table._height);
+
+		TPixel* it = destination._pixels;
+		for (const RemapTable::Entry& entry : table._entries)
+		{
+			if (entry.flags & RemapTable::_outside)
+			{
+				*(it++) = _zeroColor;
+				continue;
 			}
 
-			delete tensor;
-			if (_owner)
+			// Gather the four taps, missing neighbours on the last row or column have a zero weight
+
+			const TPixel* itTopLeft = _pixels + entry.offset;
+			const TPixel* itTopRight = itTopLeft + (entry.flags & RemapTable::_hasRight);
+			const TPixel* itBottomLeft = itTopLeft + ((entry.flags & RemapTable::_hasBottom) ? _width : 0);
+			const TPixel* itBottomRight = itBottomLeft + (entry.flags & RemapTable::_hasRight);
+
+			const TAccumulator xRight = entry.xFraction;
+			const TAccumulator xLeft = 256 - xRight;
+			const TAccumulator yBottom = entry.yFraction;
+			const TAccumulator yTop = 256 - yBottom;
+
+			for (uint8_t k = 0; k < componentCount; ++k)
 			{
-				delete[] _pixels;
+				const TAccumulator value = ((*itTopLeft)[k] * xLeft + (*itTopRight)[k] * xRight) * yTop + ((*itBottomLeft)[k] * xLeft + (*itBottomRight)[k] * xRight) * yBottom;
+				if constexpr (std::floating_point<TComponent>)
+				{
+					(*it)[k] = value * (1.f / 65536);
+				}
+				else
+				{
+					(*it)[k] = (value + 32768) >> 16;
+				}
 			}
-			_pixels = pixels;
+
+			++it;
 		}
 	}
 
@@ -591,25 +1325,17 @@ namespace djv
 
 		if constexpr (Vertically && Horizontally)
 		{
-			index = 0;
-			revIndex = _width * _height - 1;
-			for (; index < revIndex; ++index, --revIndex)
-			{
-				std::swap(_pixels[index], _pixels[revIndex]);
-			}
+			rotate180();
 		}
 		else if constexpr (Vertically && !Horizontally)
 		{
 			const uint64_t halfHeight = _height / 2;
 
-			index = 0;
 			for (uint64_t j = 0; j < halfHeight; ++j)
 			{
+				index = j * _width;
 				revIndex = (_height - j - 1) * _width;
-				for (uint64_t i = 0; i < _width; ++i, ++index, ++revIndex)
-				{
-					std::swap(_pixels[index], _pixels[revIndex]);
-				}
+				std::swap_ranges(_pixels + index, _pixels + index + _width, _pixels + revIndex);
 			}
 		}
 		else if constexpr (!Vertically && Horizontally)
@@ -617,11 +1343,8 @@ namespace djv
 			for (uint64_t j = 0; j < _height; ++j)
 			{
 				index = j * _width;
-				revIndex = (j + 1) * _width - 1;
-				for (; index < revIndex; ++index, --revIndex)
-				{
-					std::swap(_pixels[index], _pixels[revIndex]);
-				}
+				revIndex = (j + 1) * _width;
+				_djv::reversePixels(_pixels + index, _pixels + revIndex);
 			}
 		}
 	}
@@ -630,14 +1353,27 @@ namespace djv
 	template<CShape TShape>
 	constexpr void Image<TPixel>::draw(const TShape& shape, const TPixel& color)
 	{
-		typename TShape::Generator generator = shape.getGenerator();
-		
-		int64_t x, y;
-		while (generator.getNextPixel(x, y))
+		if constexpr (CSpanShape<TShape>)
+		{
+			typename TShape::SpanGenerator generator = shape.getSpanGenerator(_width, _height);
+
+			int64_t y, xBegin, xEnd;
+			while (generator.getNextSpan(y, xBegin, xEnd))
+			{
+				std::fill_n(_pixels + y * _width + xBegin, xEnd - xBegin, color);
+			}
+		}
+		else
 		{
-			if (x >= 0 && y >= 0 && x < _width && y < _height)
+			typename TShape::Generator generator = shape.getGenerator();
+
+			int64_t x, y;
+			while (generator.getNextPixel(x, y))
 			{
-				_pixels[x * _height + y] = color;
+				if (x >= 0 && y >= 0 && x < _width && y < _height)
+				{
+					_pixels[y * _width + x] = color;
+				}
 			}
 		}
 	}
@@ -653,37 +1389,152 @@ namespace djv
 			- Pixels out of image but in shape should be drawn using BBehaviour/_zeroColor
 		*/
 
-		typename TShape::Generator generator = shape.getGenerator();
+		if constexpr (CSpanShape<TShape>)
+		{
+			typename TShape::SpanGenerator generator = shape.getSpanGenerator(std::min(_width, image._width), std::min(_height, image._height));
+
+			int64_t y, xBegin, xEnd;
+			while (generator.getNextSpan(y, xBegin, xEnd))
+			{
+				std::copy_n(image._pixels + y * image._width + xBegin, xEnd - xBegin, _pixels + y * _width + xBegin);
+			}
+		}
+		else
+		{
+			typename TShape::Generator generator = shape.getGenerator();
+
+			int64_t x, y;
+			while (generator.getNextPixel(x, y))
+			{
+				if (x >= 0 && y >= 0 && x < _width && y < _height && x < image._width && y < image._height)
+				{
+					_pixels[y * _width + x] = image._pixels[y * image._width + x];
+				}
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::draw(const DrawList<TPixel>& drawList)
+	{
+		assert(drawList._width == _width);
+		assert(drawList._height == _height);
+
+		// A single sweep over the image, band by band, so that overlapping shapes hit rows that are still in cache
 
-		int64_t x, y;
-		while (generator.getNextPixel(x, y))
+		for (const std::vector<typename DrawList<TPixel>::Span>& band : drawList._bands)
 		{
-			if (x >= 0 && y >= 0 && x < _width && y < _height && x < image._width && y < image._height)
+			for (const typename DrawList<TPixel>::Span& span : band)
 			{
-				_pixels[y * _width + x] = image._pixels[y * image._width + x];
+				std::fill_n(_pixels + span.y * _width + span.xBegin, span.xEnd - span.xBegin, drawList._colors[span.color]);
 			}
 		}
 	}
 
 	template<CPixel TPixel>
-	template<scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::blend(const Image<TPixel>& image, int64_t x, int64_t y, BlendMode mode)
+	{
+		blend(image, x, y, mode, 1.f);
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::blend(const Image<TPixel>& image, int64_t x, int64_t y, BlendMode mode, float alpha)
+	{
+		const int64_t left = std::max<int64_t>(x, 0);
+		const int64_t right = std::min<int64_t>(x + int64_t(image._width), _width);
+		const int64_t top = std::max<int64_t>(y, 0);
+		const int64_t bottom = std::min<int64_t>(y + int64_t(image._height), _height);
+
+		if (left >= right)
+		{
+			return;
+		}
+
+		for (int64_t j = top; j < bottom; ++j)
+		{
+			_djv::blendRow(_pixels + j * _width + left, image._pixels + (j - y) * image._width + (left - x), right - left, mode, alpha);
+		}
+	}
+
+	template<CPixel TPixel>
+	template<CShape TShape>
+	constexpr void Image<TPixel>::draw(const TShape& shape, const Image<TPixel>& image, int64_t xOffset, int64_t yOffset, BlendMode mode, float alpha)
+	{
+		if constexpr (CSpanShape<TShape>)
+		{
+			const int64_t left = std::max<int64_t>(xOffset, 0);
+			const int64_t right = xOffset + int64_t(image._width);
+			const int64_t top = std::max<int64_t>(yOffset, 0);
+			const int64_t bottom = yOffset + int64_t(image._height);
+
+			typename TShape::SpanGenerator generator = shape.getSpanGenerator(_width, _height);
+
+			int64_t y, xBegin, xEnd;
+			while (generator.getNextSpan(y, xBegin, xEnd))
+			{
+				xBegin = std::max(xBegin, left);
+				xEnd = std::min(xEnd, right);
+
+				if (y >= top && y < bottom && xBegin < xEnd)
+				{
+					_djv::blendRow(_pixels + y * _width + xBegin, image._pixels + (y - yOffset) * image._width + (xBegin - xOffset), xEnd - xBegin, mode, alpha);
+				}
+			}
+		}
+		else
+		{
+			typename TShape::Generator generator = shape.getGenerator();
+
+			int64_t x, y;
+			while (generator.getNextPixel(x, y))
+			{
+				const int64_t xSource = x - xOffset;
+				const int64_t ySource = y - yOffset;
+
+				if (x >= 0 && y >= 0 && x < _width && y < _height && xSource >= 0 && ySource >= 0 && xSource < image._width && ySource < image._height)
+				{
+					_djv::blendRow(_pixels + y * _width + x, image._pixels + ySource * image._width + xSource, 1, mode, alpha);
+				}
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	template<scp::BorderBehaviour BBehaviour, GaussianMethod GMethod>
 	constexpr void Image<TPixel>::blurGaussian(float sigma)
 	{
-		blurGaussian<BBehaviour>(sigma, sigma);
+		blurGaussian<BBehaviour, GMethod>(sigma, sigma);
 	}
 
 	template<CPixel TPixel>
-	template<scp::BorderBehaviour BBehaviour>
+	template<scp::BorderBehaviour BBehaviour, GaussianMethod GMethod>
 	constexpr void Image<TPixel>::blurGaussian(float sigmaX, float sigmaY)
 	{
+		if constexpr (GMethod == GaussianMethod::Box)
+		{
+			uint64_t radiiX[3], radiiY[3];
+			_djv::boxBlurRadii(sigmaX, radiiX);
+			_djv::boxBlurRadii(sigmaY, radiiY);
+
+			for (uint8_t i = 0; i < 3; ++i)
+			{
+				blurMean<BBehaviour>(radiiX[i], radiiY[i]);
+			}
+
+			return;
+		}
+		else if constexpr (GMethod == GaussianMethod::Recursive)
+		{
+			_blurGaussianRecursive<BBehaviour>(sigmaX, sigmaY);
+			return;
+		}
+
 		static constexpr float sigmaToRadius = 3.f;
 		const int64_t rx = sigmaX * sigmaToRadius;
 		const int64_t ry = sigmaY * sigmaToRadius;
 		const uint64_t dx = 2 * rx + 1;
 		const uint64_t dy = 2 * ry + 1;
 
-		float acc[componentCount];
-
 		// Compute gaussian weights
 
 		float gaussianFactorX = 0.f;
@@ -712,67 +1563,68 @@ namespace djv
 			weightsY[i] /= gaussianFactorY;
 		}
 
-		// Compute gaussian blur horizontally
+		using TWeight = std::conditional_t<_djv::isFixedPointBlur<TComponent>, uint16_t, float>;
+		using TAccumulator = std::conditional_t<_djv::isFixedPointBlur<TComponent>, uint32_t, float>;
 
-		TPixel* scanline = new TPixel[std::max(_width, _height)];
+		TWeight* kernelX = reinterpret_cast<TWeight*>(alloca(sizeof(TWeight) * dx));
+		TWeight* kernelY = reinterpret_cast<TWeight*>(alloca(sizeof(TWeight) * dy));
+		_djv::quantizeBlurWeights(weightsX, dx, kernelX);
+		_djv::quantizeBlurWeights(weightsY, dy, kernelY);
 
-		TPixel* it = _pixels;
-		for (int64_t j = 0; j < _height; ++j)
-		{
-			for (int64_t i = 0; i < _width; ++i, ++scanline)
-			{
-				std::fill_n(acc, componentCount, 0.f);
-				for (int64_t p = 0, x = i - rx; p < dx; ++p, ++x)
-				{
-					const TPixel& pixel = getOutOfBound<BBehaviour>(x, j);
-					for (uint8_t k = 0; k < componentCount; ++k)
-					{
-						acc[k] += pixel[k] * weightsX[p];
-					}
-				}
+		// Rows are copied to a buffer padded with the out of bound pixels, so that only the padding needs border handling
 
-				for (uint8_t k = 0; k < componentCount; ++k)
-				{
-					(*scanline)[k] = acc[k];
-				}
+		std::vector<TPixel> padded(_width + 2 * rx);
+		std::vector<TAccumulator> accumulator(_width * componentCount);
+
+		// Compute gaussian blur horizontally
+
+		TPixel* it = _pixels;
+		for (int64_t j = 0; j < _height; ++j, it += _width)
+		{
+			for (int64_t i = 0; i < rx; ++i)
+			{
+				padded[i] = getOutOfBound<BBehaviour>(i - rx, j);
+				padded[rx + _width + i] = getOutOfBound<BBehaviour>(_width + i, j);
 			}
+			std::copy_n(it, _width, padded.data() + rx);
 
-			scanline -= _width;
-			std::copy_n(scanline, _width, it);
-			it += _width;
+			_djv::convolveLine(padded.data(), it, _width, kernelX, dx, accumulator.data());
 		}
 
-		// Compute gaussian blur vertically
+		// Compute gaussian blur vertically, on strips of columns whose rows are a single cache line
+
+		constexpr uint64_t stripSize = _djv::blurStripSize;
 
-		const TPixel* const scanlineEnd = scanline;
-		for (int64_t i = 0; i < _width; ++i)
+		const uint64_t rowSize = _width * componentCount;
+		const std::vector<TPixel> zeroRow(_width, _zeroColor);
+		std::vector<TComponent> strip((_height + 2 * ry) * stripSize);
+
+		for (uint64_t begin = 0; begin < rowSize; begin += stripSize)
 		{
-			for (int64_t j = 0; j < _height; ++j, ++scanline)
+			const uint64_t size = std::min(stripSize, rowSize - begin);
+			_djv::gatherStrip<BBehaviour>(&_pixels[0][0] + begin, &zeroRow[0][0] + begin, rowSize, _height, ry, size, strip.data());
+
+			TComponent* itDst = &_pixels[0][0] + begin;
+			for (int64_t j = 0; j < _height; ++j, itDst += rowSize)
 			{
-				std::fill_n(acc, componentCount, 0.f);
-				for (int64_t q = 0, y = j - ry; q < dy; ++q, ++y)
+				TAccumulator acc[stripSize] = {};
+
+				const TComponent* itSrc = strip.data() + j * stripSize;
+				for (int64_t q = 0; q < dy; ++q, itSrc += stripSize)
 				{
-					const TPixel& pixel = getOutOfBound<BBehaviour>(i, y);
-					for (uint8_t k = 0; k < componentCount; ++k)
+					const TWeight weight = kernelY[q];
+					for (uint64_t n = 0; n < stripSize; ++n)
 					{
-						acc[k] += pixel[k] * weightsY[q];
+						acc[n] += itSrc[n] * weight;
 					}
 				}
 
-				for (uint8_t k = 0; k < componentCount; ++k)
+				for (uint64_t n = 0; n < size; ++n)
 				{
-					(*scanline)[k] = acc[k];
+					itDst[n] = _djv::blurCast<TComponent>(acc[n]);
 				}
 			}
-
-			it = _pixels + i + _width * (_height - 1);
-			for (; scanline != scanlineEnd; it -= _width)
-			{
-				*it = *(--scanline);
-			}
 		}
-
-		delete[] scanline;
 	}
 
 	template<CPixel TPixel>
@@ -786,94 +1638,58 @@ namespace djv
 	template<scp::BorderBehaviour BBehaviour>
 	constexpr void Image<TPixel>::blurMean(uint64_t radiusX, uint64_t radiusY)
 	{
-		const int64_t rx = radiusX;
-		const int64_t ry = radiusY;
-		const uint64_t dx = 2 * rx + 1;
-		const uint64_t dy = 2 * ry + 1;
-
-		float acc[componentCount];
+		// Sums of 8 and 16-bit unsigned components are kept in 32-bit integers, and divided with a fixed point multiplication.
+		// Windows too large for that use 64-bit sums and a plain division.
 
-		// Compute mean blur horizontally
-
-		TPixel* scanline = new TPixel[std::max(_width, _height)];
-
-		TPixel* it = _pixels;
-		for (int64_t j = 0; j < _height; ++j)
+		if constexpr (_djv::isFixedPointBlur<TComponent>)
 		{
-			std::fill_n(acc, componentCount, 0.f);
-			for (int64_t i = -rx; i <= rx; ++i)
-			{
-				const TPixel& pixel = getOutOfBound<BBehaviour>(i, j);
-				for (uint8_t k = 0; k < componentCount; ++k)
-				{
-					acc[k] += pixel[k];
-				}
-			}
-
-			for (uint8_t k = 0; k < componentCount; ++k)
+			if (std::max(radiusX, radiusY) * 2 + 1 >= _djv::blurMeanCountLimit<TComponent>)
 			{
-				(*scanline)[k] = acc[k] / dx;
+				_blurMean<BBehaviour, uint64_t>(radiusX, radiusY);
 			}
-			++scanline;
-
-			for (int64_t i = 1, iPreced = -rx, iNext = 1 + rx; i < _width; ++i, ++iPreced, ++iNext, ++scanline)
+			else
 			{
-				const TPixel& pixelPreced = getOutOfBound<BBehaviour>(iPreced, j);
-				const TPixel& pixelNext = getOutOfBound<BBehaviour>(iNext, j);
-				for (uint8_t k = 0; k < componentCount; ++k)
-				{
-					acc[k] -= pixelPreced[k];
-					acc[k] += pixelNext[k];
-					(*scanline)[k] = acc[k] / dx;
-				}
+				_blurMean<BBehaviour, uint32_t>(radiusX, radiusY);
 			}
-
-			scanline -= _width;
-			std::copy_n(scanline, _width, it);
-			it += _width;
 		}
+		else
+		{
+			_blurMean<BBehaviour, float>(radiusX, radiusY);
+		}
+	}
 
-		// Compute mean blur vertically
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::blurMean(const IntegralImage<TPixel>& integral, uint64_t radius)
+	{
+		blurMean(integral, radius, radius);
+	}
 
-		const TPixel* const scanlineEnd = scanline;
-		for (int64_t i = 0; i < _width; ++i)
-		{
-			std::fill_n(acc, componentCount, 0.0);
-			for (int64_t j = -ry; j <= ry; ++j)
-			{
-				const TPixel& pixel = getOutOfBound<BBehaviour>(i, j);
-				for (uint8_t k = 0; k < componentCount; ++k)
-				{
-					acc[k] += pixel[k];
-				}
-			}
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::blurMean(const IntegralImage<TPixel>& integral, uint64_t radiusX, uint64_t radiusY)
+	{
+		assert(integral.getWidth() == _width);
+		assert(integral.getHeight() == _height);
+		assert(radiusX <= integral.getXPadding());
+		assert(radiusY <= integral.getYPadding());
 
-			for (uint8_t k = 0; k < componentCount; ++k)
-			{
-				(*scanline)[k] = acc[k] / dy;
-			}
-			++scanline;
+		const int64_t rx = radiusX;
+		const int64_t ry = radiusY;
+		const uint64_t count = (2 * radiusX + 1) * (2 * radiusY + 1);
+
+		// Each pixel is the mean of its box, read from the integral in constant time whatever the radii
 
-			for (int64_t j = 1, jPreced = -ry, jNext = 1 + ry; j < _height; ++j, ++jPreced, ++jNext, ++scanline)
+		TPixel* it = _pixels;
+		for (int64_t j = 0; j < _height; ++j)
+		{
+			for (int64_t i = 0; i < _width; ++i, ++it)
 			{
-				const TPixel& pixelPreced = getOutOfBound<BBehaviour>(i, jPreced);
-				const TPixel& pixelNext = getOutOfBound<BBehaviour>(i, jNext);
+				const std::array<typename IntegralImage<TPixel>::AccumulatorType, componentCount> sums = integral.sum(i - rx, j - ry, i + rx + 1, j + ry + 1);
 				for (uint8_t k = 0; k < componentCount; ++k)
 				{
-					acc[k] -= pixelPreced[k];
-					acc[k] += pixelNext[k];
-					(*scanline)[k] = acc[k] / dy;
+					(*it)[k] = _djv::integralMeanCast<TComponent>(sums[k], count);
 				}
 			}
-
-			it = _pixels + i + _width * (_height - 1);
-			for (; scanline != scanlineEnd; it -= _width)
-			{
-				*it = *(--scanline);
-			}
 		}
-
-		delete[] scanline;
 	}
 
 	template<CPixel TPixel>
@@ -1122,282 +1938,674 @@ namespace djv
 			}
 		}
 
-		itResult -= _width * _height;
-		std::copy_n(itResult, _width * _height, _pixels);
-		delete[] itResult;
+		itResult -= _width * _height;
+		std::copy_n(itResult, _width * _height, _pixels);
+		delete[] itResult;
+	}
+
+	template<CPixel TPixel>
+	template<scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::filterKuwahara(uint64_t radius)
+	{
+		filterKuwahara<BBehaviour>(radius, radius);
+	}
+
+	template<CPixel TPixel>
+	template<scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::filterKuwahara(uint64_t radiusX, uint64_t radiusY)
+	{
+		// TODO: implement it.
+	}
+
+	template<CPixel TPixel>
+	constexpr bool Image<TPixel>::operator==(const Image<TPixel>& image) const
+	{
+		return _width == image._width && _height == image._height && std::equal(_pixels, _pixels + _width * _height, image._pixels);
+	}
+
+	template<CPixel TPixel>
+	constexpr bool Image<TPixel>::operator!=(const Image<TPixel>& image) const
+	{
+		return !operator==(image);
+	}
+
+	template<CPixel TPixel>
+	constexpr TPixel& Image<TPixel>::operator[](const std::initializer_list<uint64_t>& indices)
+	{
+		assert(indices.size() == 2);
+		assert(indices.begin()[0] < _width && indices.begin()[1] < _height);
+
+		return _pixels[indices.begin()[1] * _width + indices.begin()[0]];
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel& Image<TPixel>::operator[](const std::initializer_list<uint64_t>& indices) const
+	{
+		assert(indices.size() == 2);
+		assert(indices.begin()[0] < _width && indices.begin()[1] < _height);
+
+		return _pixels[indices.begin()[1] * _width + indices.begin()[0]];
+	}
+
+	template<CPixel TPixel>
+	template<scp::BorderBehaviour BBehaviour>
+	constexpr const TPixel& Image<TPixel>::getOutOfBound(int64_t x, int64_t y) const
+	{
+		if constexpr (BBehaviour == scp::BorderBehaviour::Zero)
+		{
+			if (x < 0 || x >= _width || y < 0 || y >= _height)
+			{
+				return _zeroColor;
+			}
+			else
+			{
+				return _pixels[y * _width + x];
+			}
+		}
+		else if constexpr (BBehaviour == scp::BorderBehaviour::Continuous)
+		{
+			uint64_t ux = x & -(x > 0);
+			ux = (ux | -(ux >= _width)) & ((_width - 1) | -(ux < _width));
+
+			uint64_t uy = y & -(y > 0);
+			uy = (uy | -(uy >= _height)) & ((_height - 1) | -(uy < _height));
+
+			return _pixels[uy * _width + ux];
+		}
+		else if constexpr (BBehaviour == scp::BorderBehaviour::Periodic)
+		{
+			int64_t ux = x;
+			if (x < 0 || x >= _width)
+			{
+				ux = x % static_cast<int64_t>(_width);
+				ux += _width & -(ux < 0);
+			}
+
+			int64_t uy = y;
+			if (y < 0 || y >= _height)
+			{
+				uy = y % static_cast<int64_t>(_height);
+				uy += _height & -(uy < 0);
+			}
+
+			return _pixels[uy * _width + ux];
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr TPixel* Image<TPixel>::begin()
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr TPixel* Image<TPixel>::end()
+	{
+		return _pixels + _width * _height;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel* Image<TPixel>::begin() const
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel* Image<TPixel>::end() const
+	{
+		return _pixels + _width * _height;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel* Image<TPixel>::cbegin() const
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel* Image<TPixel>::cend() const
+	{
+		return _pixels + _width * _height;
+	}
+
+	template<CPixel TPixel>
+	constexpr const ruc::Status& Image<TPixel>::getStatus() const
+	{
+		return _status;
+	}
+
+	template<CPixel TPixel>
+	constexpr const uint64_t& Image<TPixel>::getWidth() const
+	{
+		return _width;
+	}
+
+	template<CPixel TPixel>
+	constexpr const uint64_t& Image<TPixel>::getHeight() const
+	{
+		return _height;
+	}
+
+	template<CPixel TPixel>
+	constexpr TPixel* Image<TPixel>::getData()
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel* Image<TPixel>::getData() const
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr bool Image<TPixel>::isValid() const
+	{
+		return _pixels;
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::setZeroColor(const TPixel& color)
+	{
+		_zeroColor = color;
+	}
+
+	template<CPixel TPixel>
+	constexpr const TPixel& Image<TPixel>::getZeroColor() const
+	{
+		return _zeroColor;
+	}
+
+	template<CPixel TPixel>
+	constexpr Image<TPixel>::~Image()
+	{
+		_destroy();
 	}
 
 	template<CPixel TPixel>
-	template<scp::BorderBehaviour BBehaviour>
-	constexpr void Image<TPixel>::filterKuwahara(uint64_t radius)
+	constexpr void Image<TPixel>::_create(uint64_t width, uint64_t height)
 	{
-		filterKuwahara<BBehaviour>(radius, radius);
+		_width = width;
+		_height = height;
+		_pixels = new TPixel[_width * _height];
+		_owner = true;
 	}
 
 	template<CPixel TPixel>
-	template<scp::BorderBehaviour BBehaviour>
-	constexpr void Image<TPixel>::filterKuwahara(uint64_t radiusX, uint64_t radiusY)
+	constexpr void Image<TPixel>::_copyFrom(const Image<TPixel>& image)
 	{
-		// TODO: implement it.
+		if (_width != image._width || _height != image._height)
+		{
+			_destroy();
+			_create(image._width, image._height);
+		}
+
+		_status = image._status;
+		std::copy_n(image._pixels, _width * _height, _pixels);
 	}
 
 	template<CPixel TPixel>
-	constexpr bool Image<TPixel>::operator==(const Image<TPixel>& image) const
+	constexpr void Image<TPixel>::_moveFrom(Image<TPixel>&& image)
 	{
-		return _width == image._width && _height == image._height && std::equal(_pixels, _pixels + _width * _height, image._pixels);
+		if (!_owner || !image._owner)
+		{
+			_copyFrom(image);
+			return;
+		}
+
+		_destroy();
+
+		_status = std::move(image._status);
+		_width = image._width;
+		_height = image._height;
+		_pixels = image._pixels;
+		_zeroColor = image._zeroColor;
+
+		image._width = 0;
+		image._height = 0;
+		image._pixels = nullptr;
 	}
 
 	template<CPixel TPixel>
-	constexpr bool Image<TPixel>::operator!=(const Image<TPixel>& image) const
+	constexpr void Image<TPixel>::_destroy()
 	{
-		return !operator==(image);
+		if (_pixels && _owner)
+		{
+			delete[] _pixels;
+		}
+
+		_width = 0;
+		_height = 0;
+		_pixels = nullptr;
+		_owner = true;
 	}
 
 	template<CPixel TPixel>
-	constexpr TPixel& Image<TPixel>::operator[](const std::initializer_list<uint64_t>& indices)
+	constexpr void Image<TPixel>::_resample(const Image<TPixel>& image, ResamplingFilter filter)
 	{
-		assert(indices.size() == 2);
-		assert(indices.begin()[0] < _width && indices.begin()[1] < _height);
+		_djv::StreamResampler<TPixel> resampler(_width, _height, filter);
+		resampler.begin(_pixels, image._width, image._height);
 
-		return _pixels[indices.begin()[1] * _width + indices.begin()[0]];
+		const TPixel* itImage = image._pixels;
+		for (uint64_t j = 0; j < image._height; ++j, itImage += image._width)
+		{
+			resampler.pushSourceRow(itImage);
+		}
 	}
 
 	template<CPixel TPixel>
-	constexpr const TPixel& Image<TPixel>::operator[](const std::initializer_list<uint64_t>& indices) const
+	constexpr void Image<TPixel>::_transposeReplace(int64_t sourceOffset, int64_t sourceStride, int64_t destinationOffset, int64_t destinationStride)
 	{
-		assert(indices.size() == 2);
-		assert(indices.begin()[0] < _width && indices.begin()[1] < _height);
+		TPixel* pixels = new TPixel[_width * _height];
+		_djv::transposeBlock(_pixels + sourceOffset, sourceStride, pixels + destinationOffset, destinationStride, _width, _height);
 
-		return _pixels[indices.begin()[1] * _width + indices.begin()[0]];
+		if (_owner)
+		{
+			delete[] _pixels;
+			_pixels = pixels;
+		}
+		else
+		{
+			std::copy_n(pixels, _width * _height, _pixels);
+			delete[] pixels;
+		}
+
+		std::swap(_width, _height);
 	}
 
 	template<CPixel TPixel>
-	template<scp::BorderBehaviour BBehaviour>
-	constexpr const TPixel& Image<TPixel>::getOutOfBound(int64_t x, int64_t y) const
+	template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour, bool Perspective>
+	constexpr void Image<TPixel>::_warp(const float* matrix, uint64_t width, uint64_t height)
 	{
-		if constexpr (BBehaviour == scp::BorderBehaviour::Zero)
+		assert(width != 0);
+		assert(height != 0);
+
+		// Source coordinates where every tap of the interpolation kernel is inside the image, with a small safety margin
+
+		constexpr double margin = 1e-3;
+		constexpr double lowMargin = (IMethod == scp::InterpolationMethod::Nearest) ? -0.5 : (IMethod == scp::InterpolationMethod::Linear) ? 0.0 : 1.0;
+		constexpr double highMargin = (IMethod == scp::InterpolationMethod::Nearest) ? 0.5 : (IMethod == scp::InterpolationMethod::Linear) ? 1.0 : 2.0;
+		const double xMin = lowMargin + margin;
+		const double xMax = _width - highMargin - margin;
+		const double yMin = lowMargin + margin;
+		const double yMax = _height - highMargin - margin;
+
+		TPixel* pixels = new TPixel[width * height];
+		TPixel* it = pixels;
+
+		for (uint64_t j = 0; j < height; ++j)
 		{
-			if (x < 0 || x >= _width || y < 0 || y >= _height)
+			// Homogeneous source coordinates of the first pixel of the row, and their step along the row
+
+			double x = matrix[1] * j + matrix[2];
+			double y = matrix[4] * j + matrix[5];
+			double z = 1.0;
+			const double dx = matrix[0];
+			const double dy = matrix[3];
+			double dz = 0.0;
+			if constexpr (Perspective)
 			{
-				return _zeroColor;
+				z = matrix[7] * j + matrix[8];
+				dz = matrix[6];
+			}
+
+			// Range of the row where sampling needs no bound check. With z > 0, xMin <= x / z <= xMax is linear in i.
+
+			int64_t first = 0;
+			int64_t last = width;
+			const double sign = (z > 0.0) ? 1.0 : -1.0;
+			if (sign * z > 0.0 && sign * (z + dz * (width - 1)) > 0.0)
+			{
+				_djv::restrictWarpInterval(sign * (x - xMin * z), sign * (dx - xMin * dz), first, last);
+				_djv::restrictWarpInterval(sign * (xMax * z - x), sign * (xMax * dz - dx), first, last);
+				_djv::restrictWarpInterval(sign * (y - yMin * z), sign * (dy - yMin * dz), first, last);
+				_djv::restrictWarpInterval(sign * (yMax * z - y), sign * (yMax * dz - dy), first, last);
+				first = std::min<int64_t>(first + 1, width);
+				last = std::max<int64_t>(last - 1, first);
 			}
 			else
 			{
-				return _pixels[y * _width + x];
+				first = width;
+				last = width;
+			}
+
+			// Border, interior, border
+
+			int64_t i = 0;
+			for (; i < first; ++i, ++it, x += dx, y += dy, z += dz)
+			{
+				_sample<IMethod, BBehaviour, false>(x / z, y / z, *it);
+			}
+
+			for (; i < last; ++i, ++it, x += dx, y += dy, z += dz)
+			{
+				if constexpr (Perspective)
+				{
+					_sample<IMethod, BBehaviour, true>(x / z, y / z, *it);
+				}
+				else
+				{
+					_sample<IMethod, BBehaviour, true>(x, y, *it);
+				}
+			}
+
+			for (; i < width; ++i, ++it, x += dx, y += dy, z += dz)
+			{
+				_sample<IMethod, BBehaviour, false>(x / z, y / z, *it);
 			}
 		}
-		else if constexpr (BBehaviour == scp::BorderBehaviour::Continuous)
+
+		if (_owner)
 		{
-			uint64_t ux = x & -(x > 0);
-			ux = (ux | -(ux >= _width)) & ((_width - 1) | -(ux < _width));
+			delete[] _pixels;
+		}
 
-			uint64_t uy = y & -(y > 0);
-			uy = (uy | -(uy >= _height)) & ((_height - 1) | -(uy < _height));
+		_width = width;
+		_height = height;
+		_pixels = pixels;
+		_owner = true;
+	}
 
-			return _pixels[uy * _width + ux];
+	template<CPixel TPixel>
+	template<scp::InterpolationMethod IMethod, scp::BorderBehaviour BBehaviour, bool Interior>
+	constexpr void Image<TPixel>::_sample(float x, float y, TPixel& pixel) const
+	{
+		if constexpr (!Interior)
+		{
+			x = std::clamp(x, -1e9f, 1e9f);
+			y = std::clamp(y, -1e9f, 1e9f);
 		}
-		else if constexpr (BBehaviour == scp::BorderBehaviour::Periodic)
+
+		if constexpr (IMethod == scp::InterpolationMethod::Nearest)
 		{
-			uint64_t ux = x;
-			if (x < 0 || x >= _width)
+			const int64_t i = std::floor(x + 0.5f);
+			const int64_t j = std::floor(y + 0.5f);
+
+			if constexpr (Interior)
+			{
+				pixel = _pixels[j * _width + i];
+			}
+			else
 			{
-				ux = (x % _width) + (_width & -(x < 0));
+				pixel = getOutOfBound<BBehaviour>(i, j);
 			}
+		}
+		else
+		{
+			constexpr int64_t n = (IMethod == scp::InterpolationMethod::Linear) ? 2 : 4;
+			constexpr int64_t offset = (IMethod == scp::InterpolationMethod::Linear) ? 0 : 1;
 
-			uint64_t uy = y;
-			if (y < 0 || y >= _height)
+			const float xFloor = std::floor(x);
+			const float yFloor = std::floor(y);
+			const int64_t i = static_cast<int64_t>(xFloor) - offset;
+			const int64_t j = static_cast<int64_t>(yFloor) - offset;
+
+			float xWeights[n];
+			float yWeights[n];
+			if constexpr (IMethod == scp::InterpolationMethod::Linear)
+			{
+				xWeights[1] = x - xFloor;
+				xWeights[0] = 1.f - xWeights[1];
+				yWeights[1] = y - yFloor;
+				yWeights[0] = 1.f - yWeights[1];
+			}
+			else
 			{
-				uy = (y % _height) + (_height & -(y < 0));
+				_djv::cubicWeights(x - xFloor, xWeights);
+				_djv::cubicWeights(y - yFloor, yWeights);
 			}
 
-			return _pixels[uy * _width + ux];
+			// Separable accumulation, all components of a tap at once
+
+			float acc[componentCount] = {};
+			for (int64_t v = 0; v < n; ++v)
+			{
+				float rowAcc[componentCount] = {};
+				for (int64_t u = 0; u < n; ++u)
+				{
+					const TPixel& tap = Interior ? _pixels[(j + v) * _width + i + u] : getOutOfBound<BBehaviour>(i + u, j + v);
+					for (uint8_t k = 0; k < componentCount; ++k)
+					{
+						rowAcc[k] += xWeights[u] * tap[k];
+					}
+				}
+
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					acc[k] += yWeights[v] * rowAcc[k];
+				}
+			}
+
+			for (uint8_t k = 0; k < componentCount; ++k)
+			{
+				pixel[k] = _djv::resamplingCast<ComponentType>(acc[k]);
+			}
 		}
 	}
 
 	template<CPixel TPixel>
-	constexpr TPixel* Image<TPixel>::begin()
+	template<scp::BorderBehaviour BBehaviour>
+	constexpr void Image<TPixel>::_blurGaussianRecursive(float sigmaX, float sigmaY)
 	{
-		return _pixels;
-	}
+		// Lines are padded with 3 sigma of out of bound pixels, which the filters go through before reaching the image
 
-	template<CPixel TPixel>
-	constexpr TPixel* Image<TPixel>::end()
-	{
-		return _pixels + _width * _height;
-	}
+		const int64_t px = std::max<int64_t>(std::ceil(3.f * sigmaX), 3);
+		const int64_t py = std::max<int64_t>(std::ceil(3.f * sigmaY), 3);
+		const _djv::RecursiveGaussian coefsX = _djv::recursiveGaussianCoefficients(sigmaX);
+		const _djv::RecursiveGaussian coefsY = _djv::recursiveGaussianCoefficients(sigmaY);
 
-	template<CPixel TPixel>
-	constexpr const TPixel* Image<TPixel>::begin() const
-	{
-		return _pixels;
-	}
+		// Compute gaussian blur horizontally
 
-	template<CPixel TPixel>
-	constexpr const TPixel* Image<TPixel>::end() const
-	{
-		return _pixels + _width * _height;
-	}
+		std::vector<float> line((_width + 2 * px) * componentCount);
 
-	template<CPixel TPixel>
-	constexpr const TPixel* Image<TPixel>::cbegin() const
-	{
-		return _pixels;
-	}
+		TPixel* it = _pixels;
+		for (int64_t j = 0; j < _height; ++j, it += _width)
+		{
+			float* itLine = line.data();
+			for (int64_t i = -px; i < int64_t(_width) + px; ++i, itLine += componentCount)
+			{
+				const TPixel& pixel = (i >= 0 && i < _width) ? it[i] : getOutOfBound<BBehaviour>(i, j);
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					itLine[k] = pixel[k];
+				}
+			}
 
-	template<CPixel TPixel>
-	constexpr const TPixel* Image<TPixel>::cend() const
-	{
-		return _pixels + _width * _height;
+			_djv::recursiveGaussianLine(line.data(), _width + 2 * px, componentCount, coefsX);
+
+			itLine = line.data() + px * componentCount;
+			for (uint64_t i = 0; i < _width; ++i, itLine += componentCount)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					it[i][k] = _djv::resamplingCast<TComponent>(itLine[k]);
+				}
+			}
+		}
+
+		// Compute gaussian blur vertically, on strips of columns whose rows are a single cache line
+
+		constexpr uint64_t stripSize = _djv::blurStripSize;
+
+		const uint64_t rowSize = _width * componentCount;
+		const std::vector<TPixel> zeroRow(_width, _zeroColor);
+		std::vector<float> strip((_height + 2 * py) * stripSize);
+
+		for (uint64_t begin = 0; begin < rowSize; begin += stripSize)
+		{
+			const uint64_t size = std::min(stripSize, rowSize - begin);
+			_djv::gatherStrip<BBehaviour>(&_pixels[0][0] + begin, &zeroRow[0][0] + begin, rowSize, _height, py, size, strip.data());
+
+			_djv::recursiveGaussianLine(strip.data(), _height + 2 * py, stripSize, coefsY);
+
+			const float* itSrc = strip.data() + py * stripSize;
+			TComponent* itDst = &_pixels[0][0] + begin;
+			for (int64_t j = 0; j < _height; ++j, itSrc += stripSize, itDst += rowSize)
+			{
+				for (uint64_t n = 0; n < size; ++n)
+				{
+					itDst[n] = _djv::resamplingCast<TComponent>(itSrc[n]);
+				}
+			}
+		}
 	}
 
 	template<CPixel TPixel>
-	constexpr const ruc::Status& Image<TPixel>::getStatus() const
+	template<scp::BorderBehaviour BBehaviour, typename TSum>
+	constexpr void Image<TPixel>::_blurMean(uint64_t radiusX, uint64_t radiusY)
 	{
-		return _status;
-	}
+		const int64_t rx = radiusX;
+		const int64_t ry = radiusY;
+		const uint64_t dx = 2 * rx + 1;
+		const uint64_t dy = 2 * ry + 1;
+
+		const uint64_t multiplierX = std::same_as<TSum, uint32_t> ? _djv::blurMeanMultiplier<TComponent>(dx) : 0;
+		const uint64_t multiplierY = std::same_as<TSum, uint32_t> ? _djv::blurMeanMultiplier<TComponent>(dy) : 0;
+
+		TSum acc[componentCount];
+
+		// Compute mean blur horizontally
+
+		TPixel* scanline = new TPixel[_width];
+
+		TPixel* it = _pixels;
+		for (int64_t j = 0; j < _height; ++j)
+		{
+			std::fill_n(acc, componentCount, TSum(0));
+			for (int64_t i = -rx; i <= rx; ++i)
+			{
+				const TPixel& pixel = getOutOfBound<BBehaviour>(i, j);
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					acc[k] += pixel[k];
+				}
+			}
+
+			for (uint8_t k = 0; k < componentCount; ++k)
+			{
+				(*scanline)[k] = _djv::blurMeanCast<TComponent>(acc[k], dx, multiplierX);
+			}
+			++scanline;
+
+			for (int64_t i = 1, iPreced = -rx, iNext = 1 + rx; i < _width; ++i, ++iPreced, ++iNext, ++scanline)
+			{
+				const TPixel& pixelPreced = getOutOfBound<BBehaviour>(iPreced, j);
+				const TPixel& pixelNext = getOutOfBound<BBehaviour>(iNext, j);
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					acc[k] -= pixelPreced[k];
+					acc[k] += pixelNext[k];
+					(*scanline)[k] = _djv::blurMeanCast<TComponent>(acc[k], dx, multiplierX);
+				}
+			}
+
+			scanline -= _width;
+			std::copy_n(scanline, _width, it);
+			it += _width;
+		}
 
-	template<CPixel TPixel>
-	constexpr const uint64_t& Image<TPixel>::getWidth() const
-	{
-		return _width;
-	}
+		delete[] scanline;
 
-	template<CPixel TPixel>
-	constexpr const uint64_t& Image<TPixel>::getHeight() const
-	{
-		return _height;
-	}
+		// Compute mean blur vertically, on strips of columns whose rows are a single cache line. The running sums of a strip
+		// are updated with the row entering and the row leaving the window
 
-	template<CPixel TPixel>
-	constexpr TPixel* Image<TPixel>::getData()
-	{
-		return _pixels;
-	}
+		constexpr uint64_t stripSize = _djv::blurStripSize;
 
-	template<CPixel TPixel>
-	constexpr const TPixel* Image<TPixel>::getData() const
-	{
-		return _pixels;
-	}
+		const uint64_t rowSize = _width * componentCount;
+		const std::vector<TPixel> zeroRow(_width, _zeroColor);
+		std::vector<TComponent> strip((_height + 2 * ry) * stripSize);
 
-	template<CPixel TPixel>
-	constexpr bool Image<TPixel>::isValid() const
-	{
-		return _pixels;
-	}
+		for (uint64_t begin = 0; begin < rowSize; begin += stripSize)
+		{
+			const uint64_t size = std::min(stripSize, rowSize - begin);
+			_djv::gatherStrip<BBehaviour>(&_pixels[0][0] + begin, &zeroRow[0][0] + begin, rowSize, _height, ry, size, strip.data());
 
-	template<CPixel TPixel>
-	constexpr void Image<TPixel>::setZeroColor(const TPixel& color)
-	{
-		_zeroColor = color;
-	}
+			TSum sums[stripSize] = {};
 
-	template<CPixel TPixel>
-	constexpr const TPixel& Image<TPixel>::getZeroColor() const
-	{
-		return _zeroColor;
-	}
+			const TComponent* itNext = strip.data();
+			for (int64_t q = 0; q < dy; ++q, itNext += stripSize)
+			{
+				for (uint64_t n = 0; n < stripSize; ++n)
+				{
+					sums[n] += itNext[n];
+				}
+			}
 
-	template<CPixel TPixel>
-	constexpr Image<TPixel>::~Image()
-	{
-		_destroy();
-	}
+			TComponent* itDst = &_pixels[0][0] + begin;
+			for (uint64_t n = 0; n < size; ++n)
+			{
+				itDst[n] = _djv::blurMeanCast<TComponent>(sums[n], dy, multiplierY);
+			}
 
-	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_create(uint64_t width, uint64_t height)
-	{
-		_width = width;
-		_height = height;
-		_pixels = new TPixel[_width * _height];
-		_owner = true;
-	}
+			const TComponent* itPreced = strip.data();
+			for (int64_t j = 1; j < _height; ++j, itPreced += stripSize, itNext += stripSize)
+			{
+				itDst += rowSize;
 
-	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_copyFrom(const Image<TPixel>& image)
-	{
-		if (_width != image._width || _height != image._height)
-		{
-			_destroy();
-			_create(image._width, image._height);
-		}
+				for (uint64_t n = 0; n < stripSize; ++n)
+				{
+					sums[n] -= itPreced[n];
+					sums[n] += itNext[n];
+				}
 
-		_status = image._status;
-		std::copy_n(image._pixels, _width * _height, _pixels);
+				for (uint64_t n = 0; n < size; ++n)
+				{
+					itDst[n] = _djv::blurMeanCast<TComponent>(sums[n], dy, multiplierY);
+				}
+			}
+		}
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_moveFrom(Image<TPixel>&& image)
+	constexpr void Image<TPixel>::_createFromFile(const std::filesystem::path& path, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler, FileBackend backend)
 	{
-		if (!_owner || !image._owner)
+		ImageFormat imageFormat;
+		if (!_extensionToImageFormat(path.extension(), imageFormat))
 		{
-			_copyFrom(image);
 			return;
 		}
 
-		_destroy();
+		FileIStream file(path, backend);
+		RUC_RELAYCOPY(file.getStatus(), _status, RUC_VOID);
 
-		_status = std::move(image._status);
-		_width = image._width;
-		_height = image._height;
-		_pixels = image._pixels;
-	}
+		_createFromStream(file.getStream(), imageFormat, swizzling, resampler);
 
-	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_destroy()
-	{
-		if (_pixels && _owner)
-		{
-			delete[] _pixels;
-		}
+		// A failed read only looks like the end of the file to the decoder, the file error replaces whatever it reported
 
-		_width = 0;
-		_height = 0;
-		_pixels = nullptr;
-		_owner = true;
+		RUC_RELAYCOPY(file.getStatus(), _status, RUC_VOID);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_createFromFile(const std::filesystem::path& path, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::_createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler)
 	{
-		if (!std::filesystem::exists(path))
-		{
-			return;
-		}
-
-		std::FILE* file = std::fopen(path.string().c_str(), "rb");
-		if (!file)
-		{
-			return;
-		}
+		assert(stream);
 
-		ImageFormat imageFormat;
-		if (_extensionToImageFormat(path.extension(), imageFormat))
+		for (uint8_t i = 0; i < componentCount; ++i)
 		{
-			dsk::IStream* stream = new dsk::IStream(file, _djv::read, _djv::eof);
-			_createFromStream(stream, imageFormat, swizzling);
-			delete stream;
+			assert(swizzling[i] < 4 || swizzling[i] == UINT8_MAX);
 		}
 
-		std::fclose(file);
+		(this->*(_imageFormatToLoadFunc[static_cast<size_t>(format)]))(stream, swizzling, resampler);
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_createFromStream(dsk::IStream* stream, ImageFormat format, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::_beginLoad(uint64_t width, uint64_t height, _djv::StreamResampler<TPixel>*& resampler)
 	{
-		assert(stream);
-
-		for (uint8_t i = 0; i < componentCount; ++i)
+		if (resampler && (resampler->getWidth() != width || resampler->getHeight() != height))
 		{
-			assert(swizzling[i] < 4 || swizzling[i] == UINT8_MAX);
+			createNew(resampler->getWidth(), resampler->getHeight());
+			resampler->begin(_pixels, width, height);
+		}
+		else
+		{
+			resampler = nullptr;
+			createNew(width, height);
 		}
-
-		(this->*(_imageFormatToLoadFunc[static_cast<size_t>(format)]))(stream, swizzling);
 	}
 
 	template<CPixel TPixel>
 	template<ImageFormat Format>
-	constexpr void Image<TPixel>::_createFromPnm(dsk::IStream* stream, const uint8_t* swizzling)
+	constexpr void Image<TPixel>::_createFromPnm(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler)
 	{
 		dsk::fmt::PnmIStream pnmIStream(stream);
 
@@ -1449,21 +2657,23 @@ namespace djv
 			}
 		}
 
-		createNew(pnmHeader.width, pnmHeader.height);
+		const uint64_t width = pnmHeader.width;
+		const uint64_t height = pnmHeader.height;
+		_beginLoad(width, height, resampler);
 
 		// TODO: Do better than use that... (check the component type and pnmHeader.maxSampleVal...)
 		const float ratio = 2.f / pnmHeader.maxSampleVal.value();
 
-		const uint64_t bufferCount = _width * samplesPerPixel;
-		TPixel* it = _pixels;
+		const uint64_t bufferCount = width * samplesPerPixel;
 		uint16_t* buffer = reinterpret_cast<uint16_t*>(alloca(bufferCount * sizeof(uint16_t)));
 
-		for (uint64_t j = 0; j < _height; ++j)
+		for (uint64_t j = 0; j < height; ++j)
 		{
-			pnmIStream.readPixels(buffer, _width);
+			pnmIStream.readPixels(buffer, width);
 			RUC_RELAYCOPY(pnmIStream.getStatus(), _status, RUC_VOID);
 
-			for (uint64_t i = 0; i < _width; ++i, ++it, buffer += samplesPerPixel)
+			TPixel* it = resampler ? resampler->getSourceRow() : _pixels + j * width;
+			for (uint64_t i = 0; i < width; ++i, ++it, buffer += samplesPerPixel)
 			{
 				for (uint8_t k = 0; k < componentCount; ++k)
 				{
@@ -1494,28 +2704,196 @@ namespace djv
 			}
 
 			buffer -= bufferCount;
+
+			if (resampler)
+			{
+				resampler->pushSourceRow();
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_createFromJpeg(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler)
+	{
+		fmt::JpegIStream jpegIStream(stream);
+
+		fmt::jpeg::Header jpegHeader;
+		jpegIStream.readHeader(jpegHeader);
+		RUC_RELAYCOPY(jpegIStream.getStatus(), _status, RUC_VOID);
+
+		// When downscaling, decode directly at the smallest DCT scale that is still larger than the target
+
+		if (resampler)
+		{
+			uint8_t denominator = 8;
+			while (denominator > 1 && ((jpegHeader.width + denominator - 1) / denominator < resampler->getWidth() || (jpegHeader.height + denominator - 1) / denominator < resampler->getHeight()))
+			{
+				denominator /= 2;
+			}
+			jpegIStream.setScaleDenominator(denominator);
+		}
+
+		const uint64_t width = jpegIStream.getOutputWidth();
+		const uint64_t height = jpegIStream.getOutputHeight();
+		_beginLoad(width, height, resampler);
+
+		const float ratio = 2.f / 255.f;
+		const uint8_t samplesPerPixel = jpegIStream.getOutputComponentCount();
+
+		uint8_t* buffer = reinterpret_cast<uint8_t*>(alloca(width * samplesPerPixel));
+
+		for (uint64_t j = 0; j < height; ++j)
+		{
+			jpegIStream.readPixels(buffer, width);
+			RUC_RELAYCOPY(jpegIStream.getStatus(), _status, RUC_VOID);
+
+			TPixel* it = resampler ? resampler->getSourceRow() : _pixels + j * width;
+			const uint8_t* itBuffer = buffer;
+			for (uint64_t i = 0; i < width; ++i, ++it, itBuffer += samplesPerPixel)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					if (swizzling[k] == UINT8_MAX)
+					{
+						(*it)[k] = colors::black<TComponent, componentCount>[k];
+					}
+					else if (swizzling[k] == 3)
+					{
+						(*it)[k] = colors::white<TComponent, componentCount>[k];
+					}
+					else if (samplesPerPixel == 1)
+					{
+						it->set(k, itBuffer[0] * ratio - 1.f);
+					}
+					else
+					{
+						it->set(k, itBuffer[swizzling[k]] * ratio - 1.f);
+					}
+				}
+			}
+
+			if (resampler)
+			{
+				resampler->pushSourceRow();
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_createFromPng(dsk::IStream* stream, const uint8_t* swizzling, _djv::StreamResampler<TPixel>* resampler)
+	{
+		fmt::PngIStream pngIStream(stream);
+
+		fmt::png::Header pngHeader;
+		pngIStream.readHeader(pngHeader);
+		RUC_RELAYCOPY(pngIStream.getStatus(), _status, RUC_VOID);
+
+		const uint64_t width = pngHeader.width;
+		const uint64_t height = pngHeader.height;
+		_beginLoad(width, height, resampler);
+
+		const float ratio = 2.f / pngIStream.getOutputMaxSampleValue();
+		const uint8_t samplesPerPixel = pngIStream.getOutputComponentCount();
+		const bool hasAlpha = (samplesPerPixel == 2 || samplesPerPixel == 4);
+
+		// Position of red, green, blue and alpha in the decoded samples
+
+		static constexpr uint8_t grayscaleChannels[4] = { 0, 0, 0, 1 };
+		static constexpr uint8_t colorChannels[4] = { 0, 1, 2, 3 };
+		const uint8_t* channels = (samplesPerPixel <= 2) ? grayscaleChannels : colorChannels;
+
+		uint16_t* buffer = reinterpret_cast<uint16_t*>(alloca(width * samplesPerPixel * sizeof(uint16_t)));
+
+		for (uint64_t j = 0; j < height; ++j)
+		{
+			pngIStream.readPixels(buffer, width);
+			RUC_RELAYCOPY(pngIStream.getStatus(), _status, RUC_VOID);
+
+			TPixel* it = resampler ? resampler->getSourceRow() : _pixels + j * width;
+			const uint16_t* itBuffer = buffer;
+			for (uint64_t i = 0; i < width; ++i, ++it, itBuffer += samplesPerPixel)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					if (swizzling[k] == UINT8_MAX)
+					{
+						(*it)[k] = colors::black<TComponent, componentCount>[k];
+					}
+					else if (swizzling[k] == 3 && !hasAlpha)
+					{
+						(*it)[k] = colors::white<TComponent, componentCount>[k];
+					}
+					else
+					{
+						it->set(k, itBuffer[channels[swizzling[k]]] * ratio - 1.f);
+					}
+				}
+			}
+
+			if (resampler)
+			{
+				resampler->pushSourceRow();
+			}
 		}
 	}
 
 	template<CPixel TPixel>
-	constexpr void Image<TPixel>::_saveToFile(const std::filesystem::path& path, const uint8_t* swizzling) const
+	constexpr void Image<TPixel>::_createFromDjv(dsk::IStream* stream, const uint8_t*, _djv::StreamResampler<TPixel>* resampler)
 	{
-		std::FILE* file = std::fopen(path.string().c_str(), "wb");
-		if (!file)
+		// Pixels are stored as is, the swizzling is ignored
+
+		fmt::native::Header header;
+		stream->read(reinterpret_cast<uint8_t*>(&header), sizeof(fmt::native::Header));
+		RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
+		RUC_CHECK(_status, RUC_VOID, fmt::native::isCompatible<TPixel>(header), "The .djv file is invalid or does not hold pixels of this type.");
+
+		uint8_t padding[256];
+		for (uint64_t size = header.dataOffset - sizeof(fmt::native::Header); size != 0;)
 		{
+			const uint64_t count = std::min<uint64_t>(size, sizeof(padding));
+			stream->read(padding, count);
+			RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
+			size -= count;
+		}
+
+		const uint64_t width = header.width;
+		const uint64_t height = header.height;
+		_beginLoad(width, height, resampler);
+
+		// Without resampling, the whole image is read in place at once
+
+		if (!resampler)
+		{
+			stream->read(reinterpret_cast<uint8_t*>(_pixels), header.stride * height);
+			RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
 			return;
 		}
 
+		for (uint64_t j = 0; j < height; ++j)
+		{
+			stream->read(reinterpret_cast<uint8_t*>(resampler->getSourceRow()), header.stride);
+			RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
+
+			resampler->pushSourceRow();
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_saveToFile(const std::filesystem::path& path, const uint8_t* swizzling, FileBackend backend) const
+	{
 		ImageFormat imageFormat;
-		if (_extensionToImageFormat(path.extension(), imageFormat))
+		if (!_extensionToImageFormat(path.extension(), imageFormat))
 		{
-			dsk::OStream* stream = new dsk::OStream(file, _djv::write);
-			_saveToStream(stream, imageFormat, swizzling);
-			stream->flush();
-			delete stream;
+			return;
 		}
 
-		std::fclose(file);
+		FileOStream file(path, backend);
+		RUC_RELAYCOPY(file.getStatus(), _status, RUC_VOID);
+
+		_saveToStream(file.getStream(), imageFormat, swizzling);
+
+		file.close();
+		RUC_RELAYCOPY(file.getStatus(), _status, RUC_VOID);
 	}
 
 	template<CPixel TPixel>
@@ -1644,6 +3022,102 @@ namespace djv
 		}
 	}
 
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_saveToJpeg(dsk::OStream*, const uint8_t*) const
+	{
+		RUC_CHECK(_status, RUC_VOID, false, "JPEG encoding is not supported.");
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_saveToPng(dsk::OStream* stream, const uint8_t* swizzling) const
+	{
+		fmt::PngOStream pngOStream(stream);
+
+		// Saved in grayscale when red, green and blue come from the same component or when only red is given
+
+		const bool grayscale = (swizzling[0] == swizzling[1] && swizzling[1] == swizzling[2]) || (swizzling[1] == UINT8_MAX && swizzling[2] == UINT8_MAX);
+		const bool hasAlpha = (swizzling[3] != UINT8_MAX);
+
+		uint8_t sources[4];
+		uint8_t samplesPerPixel = 0;
+		sources[samplesPerPixel++] = swizzling[0];
+		if (!grayscale)
+		{
+			sources[samplesPerPixel++] = swizzling[1];
+			sources[samplesPerPixel++] = swizzling[2];
+		}
+		if (hasAlpha)
+		{
+			sources[samplesPerPixel++] = swizzling[3];
+		}
+
+		fmt::png::Header pngHeader;
+		pngHeader.width = _width;
+		pngHeader.height = _height;
+		pngHeader.bitDepth = (sizeof(TComponent) == 1) ? 8 : 16;
+		pngHeader.interlaced = false;
+
+		if (grayscale)
+		{
+			pngHeader.colorType = hasAlpha ? fmt::png::ColorType::GrayscaleAlpha : fmt::png::ColorType::Grayscale;
+		}
+		else
+		{
+			pngHeader.colorType = hasAlpha ? fmt::png::ColorType::TruecolorAlpha : fmt::png::ColorType::Truecolor;
+		}
+
+		pngOStream.writeHeader(pngHeader);
+		RUC_RELAYCOPY(pngOStream.getStatus(), _status, RUC_VOID);
+
+		const TPixel* it = _pixels;
+		uint16_t* buffer = reinterpret_cast<uint16_t*>(alloca(_width * samplesPerPixel * sizeof(uint16_t)));
+
+		for (uint64_t j = 0; j < _height; ++j)
+		{
+			uint16_t* itBuffer = buffer;
+			for (uint64_t i = 0; i < _width; ++i, ++it)
+			{
+				for (uint8_t k = 0; k < samplesPerPixel; ++k, ++itBuffer)
+				{
+					if (sources[k] == UINT8_MAX)
+					{
+						*itBuffer = 0;
+					}
+					else if constexpr (sizeof(TComponent) == 1)
+					{
+						uint8_t tmp;
+						it->get(sources[k], tmp);
+						*itBuffer = tmp;
+					}
+					else
+					{
+						it->get(sources[k], *itBuffer);
+					}
+				}
+			}
+
+			pngOStream.writePixels(buffer, _width);
+			RUC_RELAYCOPY(pngOStream.getStatus(), _status, RUC_VOID);
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void Image<TPixel>::_saveToDjv(dsk::OStream* stream, const uint8_t*) const
+	{
+		// Pixels are stored as is, the swizzling is ignored
+
+		const fmt::native::Header header = fmt::native::createHeader<TPixel>(_width, _height);
+
+		uint8_t page[fmt::native::pageSize] = {};
+		std::copy_n(reinterpret_cast<const uint8_t*>(&header), sizeof(fmt::native::Header), page);
+
+		stream->write(page, header.dataOffset);
+		RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
+
+		stream->write(reinterpret_cast<const uint8_t*>(_pixels), header.stride * _height);
+		RUC_RELAYCOPY(stream->getStatus(), _status, RUC_VOID);
+	}
+
 	template<CPixel TPixel>
 	constexpr bool Image<TPixel>::_extensionToImageFormat(const std::filesystem::path& extension, ImageFormat& format)
 	{
@@ -1651,7 +3125,13 @@ namespace djv
 			{ ".pbm", ImageFormat::Pbm },
 			{ ".pgm", ImageFormat::Pgm },
 			{ ".ppm", ImageFormat::Ppm },
-			{ ".pnm", ImageFormat::Pnm }
+			{ ".pnm", ImageFormat::Pnm },
+			{ ".jpg", ImageFormat::Jpeg },
+			{ ".jpeg", ImageFormat::Jpeg },
+			{ ".jpe", ImageFormat::Jpeg },
+			{ ".jfif", ImageFormat::Jpeg },
+			{ ".png", ImageFormat::Png },
+			{ ".djv", ImageFormat::Djv }
 		};
 
 		auto it = extensionToImageFormat.find(extension);
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	template<CPixel TPixel, bool Squared>
+	constexpr IntegralImage<TPixel, Squared>::IntegralImage(uint64_t width, uint64_t height) : IntegralImage<TPixel, Squared>(width, height, 0, 0)
+	{
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr IntegralImage<TPixel, Squared>::IntegralImage(uint64_t width, uint64_t height, uint64_t xPadding, uint64_t yPadding) :
+		_width(width),
+		_height(height),
+		_xPadding(xPadding),
+		_yPadding(yPadding),
+		_rowSize((width + 2 * xPadding + 1) * componentCount),
+		_sums(_rowSize * (height + 2 * yPadding + 1), AccumulatorType(0))
+	{
+		assert(width != 0);
+		assert(height != 0);
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr IntegralImage<TPixel, Squared>::IntegralImage(const Image<TPixel>& image) : IntegralImage<TPixel, Squared>(image.getWidth(), image.getHeight(), 0, 0)
+	{
+		compute<scp::BorderBehaviour::Zero>(image);
+	}
+
+	template<CPixel TPixel, bool Squared>
+	template<scp::BorderBehaviour BBehaviour>
+	constexpr void IntegralImage<TPixel, Squared>::compute(const Image<TPixel>& image)
+	{
+		assert(image.getWidth() == _width);
+		assert(image.getHeight() == _height);
+
+		const uint64_t paddedWidth = _width + 2 * _xPadding;
+		const uint64_t paddedHeight = _height + 2 * _yPadding;
+
+		std::vector<TPixel> row(paddedWidth);
+		AccumulatorType rowSums[componentCount];
+
+		// First row and column of the table stay zero, every other entry is its row prefix sum plus the entry above it
+
+		const AccumulatorType* itAbove = _sums.data() + componentCount;
+		AccumulatorType* it = _sums.data() + _rowSize + componentCount;
+		for (uint64_t j = 0; j < paddedHeight; ++j, itAbove += componentCount, it += componentCount)
+		{
+			const int64_t y = static_cast<int64_t>(j) - static_cast<int64_t>(_yPadding);
+
+			// Gather the padded row, only the padding goes through getOutOfBound
+
+			if (y >= 0 && y < static_cast<int64_t>(_height))
+			{
+				for (uint64_t i = 0; i < _xPadding; ++i)
+				{
+					row[i] = image.template getOutOfBound<BBehaviour>(static_cast<int64_t>(i) - static_cast<int64_t>(_xPadding), y);
+					row[paddedWidth - 1 - i] = image.template getOutOfBound<BBehaviour>(_width + _xPadding - 1 - i, y);
+				}
+				std::copy_n(image.getData() + y * _width, _width, row.data() + _xPadding);
+			}
+			else
+			{
+				for (uint64_t i = 0; i < paddedWidth; ++i)
+				{
+					row[i] = image.template getOutOfBound<BBehaviour>(static_cast<int64_t>(i) - static_cast<int64_t>(_xPadding), y);
+				}
+			}
+
+			// Accumulate it
+
+			std::fill_n(rowSums, componentCount, AccumulatorType(0));
+
+			const ComponentType* itRow = &row[0][0];
+			for (uint64_t i = 0; i < paddedWidth; ++i, itRow += componentCount, itAbove += componentCount, it += componentCount)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					if constexpr (Squared)
+					{
+						rowSums[k] += static_cast<AccumulatorType>(itRow[k]) * itRow[k];
+					}
+					else
+					{
+						rowSums[k] += itRow[k];
+					}
+
+					it[k] = itAbove[k] + rowSums[k];
+				}
+			}
+		}
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr std::array<typename IntegralImage<TPixel, Squared>::AccumulatorType, IntegralImage<TPixel, Squared>::componentCount> IntegralImage<TPixel, Squared>::sum(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const
+	{
+		assert(x0 <= x1 && y0 <= y1);
+		assert(x0 >= -static_cast<int64_t>(_xPadding) && x1 <= static_cast<int64_t>(_width + _xPadding));
+		assert(y0 >= -static_cast<int64_t>(_yPadding) && y1 <= static_cast<int64_t>(_height + _yPadding));
+		assert((!std::same_as<AccumulatorType, uint32_t>) || (x1 - x0) * (y1 - y0) <= (1 << 24));
+
+		const AccumulatorType* itTop = _sums.data() + (y0 + _yPadding) * _rowSize;
+		const AccumulatorType* itBottom = _sums.data() + (y1 + _yPadding) * _rowSize;
+		const uint64_t left = (x0 + _xPadding) * componentCount;
+		const uint64_t right = (x1 + _xPadding) * componentCount;
+
+		std::array<AccumulatorType, componentCount> result;
+		for (uint8_t k = 0; k < componentCount; ++k)
+		{
+			result[k] = itBottom[right + k] - itBottom[left + k] - itTop[right + k] + itTop[left + k];
+		}
+
+		return result;
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr uint64_t IntegralImage<TPixel, Squared>::getWidth() const
+	{
+		return _width;
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr uint64_t IntegralImage<TPixel, Squared>::getHeight() const
+	{
+		return _height;
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr uint64_t IntegralImage<TPixel, Squared>::getXPadding() const
+	{
+		return _xPadding;
+	}
+
+	template<CPixel TPixel, bool Squared>
+	constexpr uint64_t IntegralImage<TPixel, Squared>::getYPadding() const
+	{
+		return _yPadding;
+	}
+}
@@ -0,0 +1,504 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		inline ThreadPool::ThreadPool(uint32_t threadCount) :
+			_threads(),
+			_tasks(),
+			_mutex(),
+			_condition(),
+			_stopping(false)
+		{
+			assert(threadCount != 0);
+
+			for (uint32_t i = 0; i < threadCount; ++i)
+			{
+				_threads.emplace_back(&ThreadPool::_run, this);
+			}
+		}
+
+		inline void ThreadPool::push(std::move_only_function<void()>&& task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_tasks.push_back(std::move(task));
+			}
+
+			_condition.notify_one();
+		}
+
+		inline ThreadPool::~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopping = true;
+			}
+
+			_condition.notify_all();
+
+			for (std::thread& thread : _threads)
+			{
+				thread.join();
+			}
+		}
+
+		inline void ThreadPool::_run()
+		{
+			while (true)
+			{
+				std::move_only_function<void()> task;
+
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_condition.wait(lock, [&]() { return _stopping || !_tasks.empty(); });
+
+					if (_tasks.empty())
+					{
+						return;
+					}
+
+					task = std::move(_tasks.front());
+					_tasks.pop_front();
+				}
+
+				task();
+			}
+		}
+	}
+
+	inline ImageIoQueue::ImageIoQueue(uint32_t threadCount, uint32_t queueDepth) :
+		_pool(threadCount),
+		_mutex(),
+		_condition(),
+		_pending(0),
+		_inFlight(0),
+		_ring(-1),
+		_queueDepth(0)
+	{
+		assert(queueDepth != 0);
+
+		_setupRing(queueDepth);
+	}
+
+	template<CPixel TPixel>
+	std::future<void> ImageIoQueue::load(Image<TPixel>& image, const std::filesystem::path& path)
+	{
+		std::promise<void> promise;
+		std::future<void> future = promise.get_future();
+
+		ImageFormat format;
+		if (!Image<TPixel>::_extensionToImageFormat(path.extension(), format))
+		{
+			promise.set_value();
+			return future;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_pending;
+		}
+
+		// The file is read by the kernel and decoded from memory by a worker thread once complete. When the read cannot be
+		// submitted or fails, the worker thread falls back on createFromFile which reports the error in the image status.
+
+		Request* request = _openRequest(path, false);
+		if (!request)
+		{
+			_pool.push([this, &image, path, promise = std::move(promise)]() mutable {
+				image.createFromFile(path);
+				_finish(promise);
+			});
+
+			return future;
+		}
+
+		request->complete = [this, &image, path, format, request, promise = std::move(promise)](bool success) mutable {
+			_pool.push([this, &image, path, format, request, success, promise = std::move(promise)]() mutable {
+				if (success)
+				{
+					MemoryIStream stream(request->data.data(), request->done);
+					image.createFromStream(stream.getStream(), format);
+				}
+				else
+				{
+					image.createFromFile(path);
+				}
+
+				delete request;
+				_finish(promise);
+			});
+		};
+
+		_submit(request, true);
+
+		return future;
+	}
+
+	template<CPixel TPixel>
+	std::future<void> ImageIoQueue::save(const Image<TPixel>& image, const std::filesystem::path& path)
+	{
+		std::promise<void> promise;
+		std::future<void> future = promise.get_future();
+
+		ImageFormat format;
+		if (!Image<TPixel>::_extensionToImageFormat(path.extension(), format))
+		{
+			promise.set_value();
+			return future;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_pending;
+		}
+
+		// The image is encoded in memory by a worker thread, then written by the kernel
+
+		_pool.push([this, &image, path, format, promise = std::move(promise)]() mutable {
+			Request* request = _openRequest(path, true);
+			if (!request)
+			{
+				image.saveToFile(path);
+				_finish(promise);
+				return;
+			}
+
+			{
+				MemoryOStream stream(request->data);
+				image.saveToStream(stream.getStream(), format);
+			}
+
+			request->complete = [this, &image, path, promise = std::move(promise)](bool success) mutable {
+				if (success)
+				{
+					_finish(promise);
+				}
+				else
+				{
+					_pool.push([this, &image, path, promise = std::move(promise)]() mutable {
+						image.saveToFile(path);
+						_finish(promise);
+					});
+				}
+			};
+
+			_submit(request, true);
+		});
+
+		return future;
+	}
+
+	inline bool ImageIoQueue::isAsynchronous() const
+	{
+		return _ring != -1;
+	}
+
+	inline ImageIoQueue::~ImageIoQueue()
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [&]() { return _pending == 0; });
+		}
+
+		_destroyRing();
+	}
+
+	inline ImageIoQueue::Request* ImageIoQueue::_openRequest(const std::filesystem::path& path, bool write)
+	{
+#ifdef DJV_IO_URING
+		if (_ring == -1)
+		{
+			return nullptr;
+		}
+
+		const int descriptor = write ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666) : ::open(path.c_str(), O_RDONLY);
+		if (descriptor == -1)
+		{
+			return nullptr;
+		}
+
+		Request* request = new Request();
+		request->descriptor = descriptor;
+		request->write = write;
+		request->done = 0;
+
+		if (!write)
+		{
+			struct stat status;
+			if (fstat(descriptor, &status) == -1 || status.st_size == 0)
+			{
+				::close(descriptor);
+				delete request;
+				return nullptr;
+			}
+
+			request->data.resize(status.st_size);
+		}
+
+		return request;
+#else
+		return nullptr;
+#endif
+	}
+
+	inline void ImageIoQueue::_submit(Request* request, bool newRequest)
+	{
+#ifdef DJV_IO_URING
+		// Empty writes never reach the kernel
+
+		if (request->done == request->data.size())
+		{
+			if (newRequest)
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				++_inFlight;
+			}
+
+			_complete(request, true);
+			return;
+		}
+
+		// Limiting the number of requests in flight to the queue depth ensures neither ring ever overflows
+
+		if (newRequest)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [&]() { return _inFlight < _queueDepth; });
+			++_inFlight;
+		}
+
+		const uint8_t opcode = request->write ? IORING_OP_WRITE : IORING_OP_READ;
+		const uint32_t size = std::min<uint64_t>(request->data.size() - request->done, 1 << 30);
+		if (!_pushEntry(opcode, request->descriptor, request->data.data() + request->done, size, request->done, reinterpret_cast<uint64_t>(request)))
+		{
+			_complete(request, false);
+		}
+#endif
+	}
+
+	inline void ImageIoQueue::_complete(Request* request, bool success)
+	{
+#ifdef DJV_IO_URING
+		::close(request->descriptor);
+#endif
+
+		// The callback may delete the request, it must not be run from inside it
+
+		std::move_only_function<void(bool)> complete = std::move(request->complete);
+		if (request->write)
+		{
+			delete request;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_inFlight;
+			_condition.notify_all();
+		}
+
+		complete(success);
+	}
+
+	inline void ImageIoQueue::_finish(std::promise<void>& promise)
+	{
+		promise.set_value();
+
+		// The notification is sent with the lock held, the queue may be destroyed as soon as it is released
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		--_pending;
+		_condition.notify_all();
+	}
+
+	inline bool ImageIoQueue::_setupRing(uint32_t queueDepth)
+	{
+#ifdef DJV_IO_URING
+		io_uring_params params = {};
+		_ring = syscall(__NR_io_uring_setup, queueDepth, &params);
+		if (_ring < 0)
+		{
+			_ring = -1;
+			return false;
+		}
+
+		// Map the submission and completion rings, which share a single mapping on recent kernels
+
+		_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+		{
+			_sqRingSize = std::max(_sqRingSize, _cqRingSize);
+			_cqRingSize = _sqRingSize;
+		}
+		_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+		void* sqRing = mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+		void* cqRing = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing : mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+		void* sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+
+		_sqRing = (sqRing == MAP_FAILED) ? nullptr : reinterpret_cast<uint8_t*>(sqRing);
+		_cqRing = (cqRing == MAP_FAILED) ? nullptr : reinterpret_cast<uint8_t*>(cqRing);
+		_sqes = (sqes == MAP_FAILED) ? nullptr : reinterpret_cast<io_uring_sqe*>(sqes);
+
+		if (!_sqRing || !_cqRing || !_sqes)
+		{
+			_destroyRing();
+			return false;
+		}
+
+		_sqTail = reinterpret_cast<uint32_t*>(_sqRing + params.sq_off.tail);
+		_sqMask = reinterpret_cast<uint32_t*>(_sqRing + params.sq_off.ring_mask);
+		_sqArray = reinterpret_cast<uint32_t*>(_sqRing + params.sq_off.array);
+		_cqHead = reinterpret_cast<uint32_t*>(_cqRing + params.cq_off.head);
+		_cqTail = reinterpret_cast<uint32_t*>(_cqRing + params.cq_off.tail);
+		_cqMask = reinterpret_cast<uint32_t*>(_cqRing + params.cq_off.ring_mask);
+		_cqes = reinterpret_cast<io_uring_cqe*>(_cqRing + params.cq_off.cqes);
+
+		_queueDepth = params.sq_entries;
+		_completionThread = std::thread(&ImageIoQueue::_reap, this);
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	inline void ImageIoQueue::_destroyRing()
+	{
+#ifdef DJV_IO_URING
+		if (_ring == -1)
+		{
+			return;
+		}
+
+		// A no-op entry without request wakes the completion thread up and stops it
+
+		if (_completionThread.joinable())
+		{
+			_pushEntry(IORING_OP_NOP, -1, nullptr, 0, 0, 0);
+			_completionThread.join();
+		}
+
+		if (_sqes)
+		{
+			munmap(_sqes, _sqesSize);
+		}
+
+		if (_cqRing && _cqRing != _sqRing)
+		{
+			munmap(_cqRing, _cqRingSize);
+		}
+
+		if (_sqRing)
+		{
+			munmap(_sqRing, _sqRingSize);
+		}
+
+		::close(_ring);
+		_ring = -1;
+#endif
+	}
+
+	inline bool ImageIoQueue::_pushEntry(uint8_t opcode, int descriptor, uint8_t* data, uint32_t size, uint64_t offset, uint64_t userData)
+	{
+#ifdef DJV_IO_URING
+		std::lock_guard<std::mutex> lock(_submitMutex);
+
+		const uint32_t tail = *_sqTail;
+		const uint32_t index = tail & *_sqMask;
+
+		io_uring_sqe& entry = _sqes[index];
+		std::memset(&entry, 0, sizeof(io_uring_sqe));
+		entry.opcode = opcode;
+		entry.fd = descriptor;
+		entry.addr = reinterpret_cast<uint64_t>(data);
+		entry.len = size;
+		entry.off = offset;
+		entry.user_data = userData;
+
+		_sqArray[index] = index;
+		std::atomic_ref<uint32_t>(*_sqTail).store(tail + 1, std::memory_order_release);
+
+		int64_t submitted;
+		while ((submitted = syscall(__NR_io_uring_enter, _ring, 1, 0, 0, nullptr, 0)) == -1 && (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+
+		// The completion thread never submits, an entry left in the ring would only be sent with the next one, if any
+
+		if (submitted != 1)
+		{
+			std::atomic_ref<uint32_t>(*_sqTail).store(tail, std::memory_order_release);
+			return false;
+		}
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	inline void ImageIoQueue::_reap()
+	{
+#ifdef DJV_IO_URING
+		bool stopping = false;
+		while (!stopping)
+		{
+			syscall(__NR_io_uring_enter, _ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+			uint32_t head = *_cqHead;
+			const uint32_t tail = std::atomic_ref<uint32_t>(*_cqTail).load(std::memory_order_acquire);
+
+			// Requests are filled before being pushed under the submission lock, taking it here makes that ordering visible
+			// to the completion thread without relying on the kernel
+
+			{
+				std::lock_guard<std::mutex> lock(_submitMutex);
+			}
+
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& entry = _cqes[head & *_cqMask];
+				Request* request = reinterpret_cast<Request*>(entry.user_data);
+				const int32_t result = entry.res;
+
+				if (!request)
+				{
+					stopping = true;
+					continue;
+				}
+
+				// Short transfers are resubmitted for the remaining bytes
+
+				if (result > 0)
+				{
+					request->done += result;
+					if (request->done != request->data.size())
+					{
+						_submit(request, false);
+						continue;
+					}
+				}
+				else if (result == -EINTR || result == -EAGAIN)
+				{
+					_submit(request, false);
+					continue;
+				}
+
+				_complete(request, result > 0 || (result == 0 && !request->write));
+			}
+
+			std::atomic_ref<uint32_t>(*_cqHead).store(head, std::memory_order_release);
+		}
+#endif
+	}
+}
@@ -0,0 +1,1337 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		inline int32_t jpegDequantize(int16_t coef, uint16_t quant)
+		{
+			// Corrupted streams can hold any coefficient and quantization value. Keeping the product in the int16 range keeps
+			// the first IDCT pass from overflowing.
+
+			return std::clamp<int32_t>(coef * quant, INT16_MIN, INT16_MAX);
+		}
+
+		// One pass of the integer IDCT (libjpeg "islow" factorisation) applied on 8 lanes at once. The input is
+		// frequency-major (in[k * 8 + lane]) and the output is space-major (out[x * 8 + lane]), so that every
+		// statement of the loop body is a plain 8-wide vector operation.
+
+		inline void jpegIdctPass(const int32_t* in, int32_t* out, uint8_t shift)
+		{
+			constexpr int32_t fix_0_298631336 = 2446;
+			constexpr int32_t fix_0_390180644 = 3196;
+			constexpr int32_t fix_0_541196100 = 4433;
+			constexpr int32_t fix_0_765366865 = 6270;
+			constexpr int32_t fix_0_899976223 = 7373;
+			constexpr int32_t fix_1_175875602 = 9633;
+			constexpr int32_t fix_1_501321110 = 12299;
+			constexpr int32_t fix_1_847759065 = 15137;
+			constexpr int32_t fix_1_961570560 = 16069;
+			constexpr int32_t fix_2_053119869 = 16819;
+			constexpr int32_t fix_2_562915447 = 20995;
+			constexpr int32_t fix_3_072711026 = 25172;
+
+			const int32_t round = 1 << (shift - 1);
+
+			for (uint8_t i = 0; i < 8; ++i)
+			{
+				// Even part
+
+				int32_t z2 = in[2 * 8 + i];
+				int32_t z3 = in[6 * 8 + i];
+				int32_t z1 = (z2 + z3) * fix_0_541196100;
+				int32_t tmp2 = z1 - z3 * fix_1_847759065;
+				int32_t tmp3 = z1 + z2 * fix_0_765366865;
+
+				z2 = in[0 * 8 + i];
+				z3 = in[4 * 8 + i];
+				int32_t tmp0 = (z2 + z3) * 8192;
+				int32_t tmp1 = (z2 - z3) * 8192;
+
+				const int32_t tmp10 = tmp0 + tmp3 + round;
+				const int32_t tmp13 = tmp0 - tmp3 + round;
+				const int32_t tmp11 = tmp1 + tmp2 + round;
+				const int32_t tmp12 = tmp1 - tmp2 + round;
+
+				// Odd part
+
+				tmp0 = in[7 * 8 + i];
+				tmp1 = in[5 * 8 + i];
+				tmp2 = in[3 * 8 + i];
+				tmp3 = in[1 * 8 + i];
+
+				z1 = tmp0 + tmp3;
+				z2 = tmp1 + tmp2;
+				z3 = tmp0 + tmp2;
+				int32_t z4 = tmp1 + tmp3;
+				const int32_t z5 = (z3 + z4) * fix_1_175875602;
+
+				tmp0 *= fix_0_298631336;
+				tmp1 *= fix_2_053119869;
+				tmp2 *= fix_3_072711026;
+				tmp3 *= fix_1_501321110;
+				z1 *= -fix_0_899976223;
+				z2 *= -fix_2_562915447;
+				z3 = z3 * -fix_1_961570560 + z5;
+				z4 = z4 * -fix_0_390180644 + z5;
+
+				tmp0 += z1 + z3;
+				tmp1 += z2 + z4;
+				tmp2 += z2 + z3;
+				tmp3 += z1 + z4;
+
+				out[0 * 8 + i] = (tmp10 + tmp3) >> shift;
+				out[7 * 8 + i] = (tmp10 - tmp3) >> shift;
+				out[1 * 8 + i] = (tmp11 + tmp2) >> shift;
+				out[6 * 8 + i] = (tmp11 - tmp2) >> shift;
+				out[2 * 8 + i] = (tmp12 + tmp1) >> shift;
+				out[5 * 8 + i] = (tmp12 - tmp1) >> shift;
+				out[3 * 8 + i] = (tmp13 + tmp0) >> shift;
+				out[4 * 8 + i] = (tmp13 - tmp0) >> shift;
+			}
+		}
+
+		inline uint8_t jpegClamp(int32_t x)
+		{
+			return static_cast<uint8_t>(std::clamp(x, 0, 255));
+		}
+	}
+
+	namespace fmt
+	{
+		inline JpegIStream::JpegIStream(dsk::IStream* stream) :
+			_stream(stream),
+			_status(),
+			_quantTables(),
+			_dcTables(),
+			_acTables(),
+			_width(0),
+			_height(0),
+			_progressive(false),
+			_colorTransform(jpeg::ColorTransform::None),
+			_adobeFound(false),
+			_adobeTransform(0),
+			_components(),
+			_hMax(1),
+			_vMax(1),
+			_mcusPerLine(0),
+			_mcusPerColumn(0),
+			_restartInterval(0),
+			_restartsLeft(0),
+			_scanComponents(),
+			_scanComponentCount(0),
+			_spectralStart(0),
+			_spectralEnd(63),
+			_approxHigh(0),
+			_approxLow(0),
+			_eobRun(0),
+			_bitBuffer(0),
+			_bitCount(0),
+			_pendingMarker(0),
+			_fullBuffer(false),
+			_allocated(false),
+			_blockSize(8),
+			_scaledTables(),
+			_mcuRow(0),
+			_rows(),
+			_rowsPos(0),
+			_rowsEnd(0)
+		{
+			assert(stream);
+
+			for (uint8_t t = 0; t < 2; ++t)
+			{
+				const uint8_t s = 2 << t;
+				for (uint8_t x = 0; x < s; ++x)
+				{
+					for (uint8_t u = 0; u < s; ++u)
+					{
+						const double c = (u == 0) ? std::numbers::sqrt2 / 2.0 : 1.0;
+						_scaledTables[t][x][u] = std::lround(4096.0 * c * std::cos((2 * x + 1) * u * std::numbers::pi / (2 * s)));
+					}
+				}
+			}
+		}
+
+		inline void JpegIStream::readHeader(jpeg::Header& header)
+		{
+			uint8_t marker;
+			if (!_readMarker(marker))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, marker == 0xD8, std::format("Expected JPEG SOI marker (0xD8) but instead got {}", marker));
+
+			bool endOfImage;
+			if (!_readTablesUntilScan(endOfImage))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, !endOfImage, "JPEG stream ends before its first scan.");
+
+			if (_components.size() == 1)
+			{
+				_colorTransform = jpeg::ColorTransform::None;
+			}
+			else if (_components.size() == 3)
+			{
+				if (_adobeFound)
+				{
+					_colorTransform = (_adobeTransform == 0) ? jpeg::ColorTransform::None : jpeg::ColorTransform::YCbCr;
+				}
+				else
+				{
+					const bool rgbIds = _components[0].id == 'R' && _components[1].id == 'G' && _components[2].id == 'B';
+					_colorTransform = rgbIds ? jpeg::ColorTransform::None : jpeg::ColorTransform::YCbCr;
+				}
+			}
+			else
+			{
+				_colorTransform = (_adobeFound && _adobeTransform == 2) ? jpeg::ColorTransform::YCCK : jpeg::ColorTransform::None;
+			}
+
+			_fullBuffer = _progressive || _scanComponentCount != _components.size();
+
+			header.width = _width;
+			header.height = _height;
+			header.componentCount = _components.size();
+			header.progressive = _progressive;
+		}
+
+		inline void JpegIStream::setScaleDenominator(uint8_t denominator)
+		{
+			assert(denominator == 1 || denominator == 2 || denominator == 4 || denominator == 8);
+			assert(!_allocated);
+
+			_blockSize = 8 / denominator;
+		}
+
+		inline void JpegIStream::readPixels(uint8_t* samples, uint64_t pixelCount)
+		{
+			assert(!_components.empty());
+
+			uint64_t sampleCount = pixelCount * getOutputComponentCount();
+			while (sampleCount)
+			{
+				if (_rowsPos == _rowsEnd)
+				{
+					RUC_CHECK(_status, RUC_VOID, _mcuRow < _mcusPerColumn, "Trying to read more pixels than the JPEG image contains.");
+
+					if (!_allocated)
+					{
+						_allocate();
+						if (_fullBuffer && !_decodeAllScans())
+						{
+							return;
+						}
+					}
+
+					if (!_fullBuffer && !_decodeMcuRow())
+					{
+						return;
+					}
+
+					_outputMcuRow();
+				}
+
+				const uint64_t count = std::min(sampleCount, _rowsEnd - _rowsPos);
+				std::copy_n(_rows.data() + _rowsPos, count, samples);
+
+				samples += count;
+				_rowsPos += count;
+				sampleCount -= count;
+			}
+		}
+
+		inline uint64_t JpegIStream::getOutputWidth() const
+		{
+			return (static_cast<uint64_t>(_width) * _blockSize + 7) / 8;
+		}
+
+		inline uint64_t JpegIStream::getOutputHeight() const
+		{
+			return (static_cast<uint64_t>(_height) * _blockSize + 7) / 8;
+		}
+
+		inline uint8_t JpegIStream::getOutputComponentCount() const
+		{
+			return (_components.size() == 1) ? 1 : 3;
+		}
+
+		inline const ruc::Status& JpegIStream::getStatus() const
+		{
+			return _status;
+		}
+
+		inline bool JpegIStream::_read(uint8_t* data, uint64_t size)
+		{
+			_stream->read(data, size);
+			RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readMarker(uint8_t& marker)
+		{
+			if (_pendingMarker)
+			{
+				marker = _pendingMarker;
+				_pendingMarker = 0;
+				return true;
+			}
+
+			uint8_t byte = 0;
+			while (byte != 0xFF)
+			{
+				if (!_read(&byte, 1))
+				{
+					return false;
+				}
+			}
+
+			while (byte == 0xFF)
+			{
+				if (!_read(&byte, 1))
+				{
+					return false;
+				}
+			}
+
+			marker = byte;
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readSegment(std::vector<uint8_t>& segment)
+		{
+			uint8_t length[2];
+			if (!_read(length, 2))
+			{
+				return false;
+			}
+
+			const uint16_t size = (length[0] << 8) | length[1];
+			RUC_CHECK(_status, false, size >= 2, std::format("Invalid JPEG segment length {}.", size));
+
+			segment.resize(size - 2);
+			return segment.empty() || _read(segment.data(), segment.size());
+		}
+
+		inline bool JpegIStream::_readQuantizationTables()
+		{
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+
+			const uint8_t* it = segment.data();
+			const uint8_t* const itEnd = it + segment.size();
+			while (it != itEnd)
+			{
+				const uint8_t precision = *it >> 4;
+				const uint8_t index = *it & 15;
+				++it;
+
+				RUC_CHECK(_status, false, index < 4, std::format("Invalid JPEG quantization table index {}.", index));
+				RUC_CHECK(_status, false, itEnd - it >= (precision ? 128 : 64), "Truncated JPEG quantization table.");
+
+				for (uint8_t i = 0; i < 64; ++i)
+				{
+					if (precision)
+					{
+						_quantTables[index][_zigzag[i]] = (it[0] << 8) | it[1];
+						it += 2;
+					}
+					else
+					{
+						_quantTables[index][_zigzag[i]] = *it;
+						++it;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readHuffmanTables()
+		{
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+
+			const uint8_t* it = segment.data();
+			const uint8_t* const itEnd = it + segment.size();
+			while (it != itEnd)
+			{
+				RUC_CHECK(_status, false, itEnd - it >= 17, "Truncated JPEG Huffman table.");
+
+				const uint8_t tableClass = *it >> 4;
+				const uint8_t index = *it & 15;
+				const uint8_t* counts = it + 1;
+				it += 17;
+
+				RUC_CHECK(_status, false, tableClass < 2 && index < 4, std::format("Invalid JPEG Huffman table {}/{}.", tableClass, index));
+
+				uint16_t valueCount = 0;
+				for (uint8_t i = 0; i < 16; ++i)
+				{
+					valueCount += counts[i];
+				}
+				RUC_CHECK(_status, false, valueCount <= 256 && itEnd - it >= valueCount, "Invalid JPEG Huffman table size.");
+
+				// DC symbols are bit counts given to _getBits, AC symbols hold theirs in the low nibble
+
+				if (tableClass == 0)
+				{
+					for (uint16_t i = 0; i < valueCount; ++i)
+					{
+						RUC_CHECK(_status, false, it[i] <= 11, std::format("Invalid JPEG DC Huffman symbol {}.", it[i]));
+					}
+				}
+
+				_buildHuffmanTable(tableClass ? _acTables[index] : _dcTables[index], counts, it);
+				it += valueCount;
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readRestartInterval()
+		{
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+			RUC_CHECK(_status, false, segment.size() == 2, "Invalid JPEG DRI segment.");
+
+			_restartInterval = (segment[0] << 8) | segment[1];
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readApplicationSegment(uint8_t marker)
+		{
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+
+			if (marker == 0xEE && segment.size() >= 12 && std::equal(segment.begin(), segment.begin() + 5, "Adobe"))
+			{
+				_adobeFound = true;
+				_adobeTransform = segment[11];
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readFrame(uint8_t marker)
+		{
+			RUC_CHECK(_status, false, _components.empty(), "JPEG streams with several frames are not supported.");
+
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+			RUC_CHECK(_status, false, segment.size() >= 6, "Truncated JPEG frame header.");
+			RUC_CHECK(_status, false, segment[0] == 8, std::format("Only 8-bit JPEG samples are supported (got {} bits).", segment[0]));
+
+			_height = (segment[1] << 8) | segment[2];
+			_width = (segment[3] << 8) | segment[4];
+			const uint8_t componentCount = segment[5];
+
+			RUC_CHECK(_status, false, _width != 0 && _height != 0, "JPEG images with DNL-defined height are not supported.");
+			RUC_CHECK(_status, false, componentCount == 1 || componentCount == 3 || componentCount == 4, std::format("Unsupported JPEG component count {}.", componentCount));
+			RUC_CHECK(_status, false, segment.size() == 6 + 3 * componentCount, "Invalid JPEG frame header size.");
+
+			_progressive = (marker == 0xC2);
+			_components.resize(componentCount);
+
+			_hMax = 1;
+			_vMax = 1;
+			for (uint8_t i = 0; i < componentCount; ++i)
+			{
+				Component& component = _components[i];
+				component.id = segment[6 + 3 * i];
+				component.h = segment[7 + 3 * i] >> 4;
+				component.v = segment[7 + 3 * i] & 15;
+				component.quantTable = segment[8 + 3 * i];
+
+				RUC_CHECK(_status, false, component.h >= 1 && component.h <= 4 && component.v >= 1 && component.v <= 4, "Invalid JPEG sampling factors.");
+				RUC_CHECK(_status, false, component.quantTable < 4, "Invalid JPEG quantization table index.");
+
+				_hMax = std::max(_hMax, component.h);
+				_vMax = std::max(_vMax, component.v);
+			}
+
+			// A single component scan is never interleaved, so its MCU is one block whatever the sampling factors
+
+			if (componentCount == 1)
+			{
+				_components[0].h = 1;
+				_components[0].v = 1;
+				_hMax = 1;
+				_vMax = 1;
+			}
+
+			_mcusPerLine = (_width + 8 * _hMax - 1) / (8 * _hMax);
+			_mcusPerColumn = (_height + 8 * _vMax - 1) / (8 * _vMax);
+
+			for (Component& component : _components)
+			{
+				component.blockWidth = ((static_cast<uint64_t>(_width) * component.h + _hMax - 1) / _hMax + 7) / 8;
+				component.blockHeight = ((static_cast<uint64_t>(_height) * component.v + _vMax - 1) / _vMax + 7) / 8;
+				component.blocksPerLine = _mcusPerLine * component.h;
+				component.blocksPerColumn = _mcusPerColumn * component.v;
+				component.dcPred = 0;
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readScanHeader()
+		{
+			RUC_CHECK(_status, false, !_components.empty(), "JPEG scan found before frame header.");
+
+			std::vector<uint8_t> segment;
+			if (!_readSegment(segment))
+			{
+				return false;
+			}
+			RUC_CHECK(_status, false, !segment.empty() && segment.size() == 4 + 2 * segment[0], "Invalid JPEG scan header.");
+
+			_scanComponentCount = segment[0];
+			RUC_CHECK(_status, false, _scanComponentCount >= 1 && _scanComponentCount <= _components.size(), "Invalid JPEG scan component count.");
+
+			for (uint8_t i = 0; i < _scanComponentCount; ++i)
+			{
+				const uint8_t id = segment[1 + 2 * i];
+				const uint8_t tables = segment[2 + 2 * i];
+
+				uint8_t index = 0;
+				while (index < _components.size() && _components[index].id != id)
+				{
+					++index;
+				}
+				RUC_CHECK(_status, false, index != _components.size(), std::format("Unknown JPEG component id {} in scan.", id));
+
+				_scanComponents[i] = index;
+				_components[index].dcTable = tables >> 4;
+				_components[index].acTable = tables & 15;
+				RUC_CHECK(_status, false, (tables >> 4) < 4 && (tables & 15) < 4, "Invalid JPEG Huffman table selector.");
+			}
+
+			const uint8_t* params = segment.data() + 1 + 2 * _scanComponentCount;
+			_spectralStart = params[0];
+			_spectralEnd = params[1];
+			_approxHigh = params[2] >> 4;
+			_approxLow = params[2] & 15;
+
+			if (_progressive)
+			{
+				RUC_CHECK(_status, false, _spectralStart <= _spectralEnd && _spectralEnd < 64, "Invalid JPEG spectral selection.");
+				RUC_CHECK(_status, false, (_spectralStart == 0) == (_spectralEnd == 0), "Invalid JPEG progressive scan.");
+				RUC_CHECK(_status, false, _spectralStart == 0 || _scanComponentCount == 1, "Progressive JPEG AC scans must contain a single component.");
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_readTablesUntilScan(bool& endOfImage)
+		{
+			endOfImage = false;
+
+			uint8_t marker;
+			while (true)
+			{
+				if (!_readMarker(marker))
+				{
+					return false;
+				}
+
+				switch (marker)
+				{
+					case 0xC0:
+					case 0xC1:
+					case 0xC2:
+					{
+						if (!_readFrame(marker))
+						{
+							return false;
+						}
+						break;
+					}
+					case 0xC4:
+					{
+						if (!_readHuffmanTables())
+						{
+							return false;
+						}
+						break;
+					}
+					case 0xDA:
+					{
+						return _readScanHeader();
+					}
+					case 0xD9:
+					{
+						endOfImage = true;
+						return true;
+					}
+					case 0xDB:
+					{
+						if (!_readQuantizationTables())
+						{
+							return false;
+						}
+						break;
+					}
+					case 0xDD:
+					{
+						if (!_readRestartInterval())
+						{
+							return false;
+						}
+						break;
+					}
+					case 0xC3:
+					case 0xC5:
+					case 0xC6:
+					case 0xC7:
+					case 0xC9:
+					case 0xCA:
+					case 0xCB:
+					case 0xCD:
+					case 0xCE:
+					case 0xCF:
+					{
+						RUC_CHECK(_status, false, false, std::format("Unsupported JPEG coding process (SOF marker {}).", marker));
+					}
+					default:
+					{
+						if (marker >= 0xD0 && marker <= 0xD7)
+						{
+							break;
+						}
+
+						if (!_readApplicationSegment(marker))
+						{
+							return false;
+						}
+						break;
+					}
+				}
+			}
+		}
+
+		inline void JpegIStream::_allocate()
+		{
+			const uint64_t s = _blockSize;
+
+			for (Component& component : _components)
+			{
+				// When downscaling, subsampled components use a larger IDCT instead of being upsampled afterwards
+
+				component.blockSize = s;
+				while (component.blockSize < 8 && _hMax % (component.h * component.blockSize * 2 / s) == 0 && _vMax % (component.v * component.blockSize * 2 / s) == 0)
+				{
+					component.blockSize *= 2;
+				}
+
+				const uint64_t blockRows = _fullBuffer ? component.blocksPerColumn : component.v;
+				component.coefs.assign(component.blocksPerLine * blockRows * 64, 0);
+				component.plane.resize(component.blocksPerLine * component.blockSize * component.v * component.blockSize);
+				component.upsampled.resize(getOutputWidth());
+			}
+
+			_rows.resize(getOutputWidth() * getOutputComponentCount() * _vMax * s);
+
+			_allocated = true;
+		}
+
+		inline bool JpegIStream::_decodeScan()
+		{
+			_bitBuffer = 0;
+			_bitCount = 0;
+			_eobRun = 0;
+			_restartsLeft = _restartInterval;
+			for (Component& component : _components)
+			{
+				component.dcPred = 0;
+			}
+
+			const auto decodeBlock = [&](Component& component, int16_t* coefs)
+			{
+				if (!_progressive)
+				{
+					_decodeBlockBaseline(component, coefs);
+				}
+				else if (_spectralStart == 0)
+				{
+					if (_approxHigh == 0)
+					{
+						_decodeBlockDcFirst(component, coefs);
+					}
+					else
+					{
+						_decodeBlockDcRefine(coefs);
+					}
+				}
+				else
+				{
+					if (_approxHigh == 0)
+					{
+						_decodeBlockAcFirst(component, coefs);
+					}
+					else
+					{
+						_decodeBlockAcRefine(component, coefs);
+					}
+				}
+			};
+
+			if (_scanComponentCount == 1)
+			{
+				Component& component = _components[_scanComponents[0]];
+				for (uint64_t j = 0; j < component.blockHeight; ++j)
+				{
+					int16_t* coefs = component.coefs.data() + j * component.blocksPerLine * 64;
+					for (uint64_t i = 0; i < component.blockWidth; ++i, coefs += 64)
+					{
+						if (!_processRestart())
+						{
+							return false;
+						}
+						decodeBlock(component, coefs);
+					}
+
+					RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+				}
+			}
+			else
+			{
+				for (uint64_t j = 0; j < _mcusPerColumn; ++j)
+				{
+					for (uint64_t i = 0; i < _mcusPerLine; ++i)
+					{
+						if (!_processRestart())
+						{
+							return false;
+						}
+
+						for (uint8_t k = 0; k < _scanComponentCount; ++k)
+						{
+							Component& component = _components[_scanComponents[k]];
+							for (uint8_t y = 0; y < component.v; ++y)
+							{
+								int16_t* coefs = component.coefs.data() + ((j * component.v + y) * component.blocksPerLine + i * component.h) * 64;
+								for (uint8_t x = 0; x < component.h; ++x, coefs += 64)
+								{
+									decodeBlock(component, coefs);
+								}
+							}
+						}
+					}
+
+					RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+				}
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_decodeAllScans()
+		{
+			bool endOfImage = false;
+			while (!endOfImage)
+			{
+				if (!_decodeScan())
+				{
+					return false;
+				}
+
+				_bitBuffer = 0;
+				_bitCount = 0;
+
+				if (!_readTablesUntilScan(endOfImage))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		inline bool JpegIStream::_decodeMcuRow()
+		{
+			if (_mcuRow == 0)
+			{
+				_bitBuffer = 0;
+				_bitCount = 0;
+				_eobRun = 0;
+				_restartsLeft = _restartInterval;
+			}
+
+			for (uint64_t i = 0; i < _mcusPerLine; ++i)
+			{
+				if (!_processRestart())
+				{
+					return false;
+				}
+
+				for (uint8_t k = 0; k < _scanComponentCount; ++k)
+				{
+					Component& component = _components[_scanComponents[k]];
+					for (uint8_t y = 0; y < component.v; ++y)
+					{
+						int16_t* coefs = component.coefs.data() + (y * component.blocksPerLine + i * component.h) * 64;
+						for (uint8_t x = 0; x < component.h; ++x, coefs += 64)
+						{
+							std::fill_n(coefs, 64, 0);
+							_decodeBlockBaseline(component, coefs);
+						}
+					}
+				}
+			}
+
+			RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+
+			return true;
+		}
+
+		inline void JpegIStream::_outputMcuRow()
+		{
+			const uint64_t s = _blockSize;
+			const uint64_t width = getOutputWidth();
+			const uint8_t outputComponentCount = getOutputComponentCount();
+
+			// Inverse DCT of every block of the MCU row, directly at the requested scale
+
+			for (Component& component : _components)
+			{
+				const uint64_t stride = component.blocksPerLine * component.blockSize;
+				const uint64_t firstBlockRow = _fullBuffer ? _mcuRow * component.v : 0;
+
+				for (uint8_t y = 0; y < component.v; ++y)
+				{
+					const int16_t* coefs = component.coefs.data() + (firstBlockRow + y) * component.blocksPerLine * 64;
+					uint8_t* output = component.plane.data() + y * component.blockSize * stride;
+					for (uint64_t i = 0; i < component.blocksPerLine; ++i, coefs += 64, output += component.blockSize)
+					{
+						_idct(coefs, _quantTables[component.quantTable], output, stride, component.blockSize);
+					}
+				}
+			}
+
+			// Upsampling and color conversion
+
+			const uint64_t mcuHeight = _vMax * s;
+			const uint64_t rowCount = std::min(mcuHeight, getOutputHeight() - _mcuRow * mcuHeight);
+			const uint8_t componentCount = _components.size();
+
+			const uint8_t* rows[4];
+			uint8_t* it = _rows.data();
+
+			for (uint64_t j = 0; j < rowCount; ++j)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					Component& component = _components[k];
+					const uint64_t h = component.h * component.blockSize / s;
+					const uint64_t v = component.v * component.blockSize / s;
+					const uint8_t* row = component.plane.data() + (j * v / _vMax) * component.blocksPerLine * component.blockSize;
+
+					if (h == _hMax)
+					{
+						rows[k] = row;
+					}
+					else
+					{
+						for (uint64_t i = 0; i < width; ++i)
+						{
+							component.upsampled[i] = row[i * h / _hMax];
+						}
+						rows[k] = component.upsampled.data();
+					}
+				}
+
+				if (componentCount == 1)
+				{
+					std::copy_n(rows[0], width, it);
+					it += width;
+				}
+				else if (_colorTransform == jpeg::ColorTransform::None && componentCount == 3)
+				{
+					for (uint64_t i = 0; i < width; ++i, it += 3)
+					{
+						it[0] = rows[0][i];
+						it[1] = rows[1][i];
+						it[2] = rows[2][i];
+					}
+				}
+				else
+				{
+					for (uint64_t i = 0; i < width; ++i, it += 3)
+					{
+						int32_t r = rows[0][i];
+						int32_t g = rows[1][i];
+						int32_t b = rows[2][i];
+
+						if (_colorTransform != jpeg::ColorTransform::None)
+						{
+							const int32_t y = rows[0][i] << 16;
+							const int32_t cb = rows[1][i] - 128;
+							const int32_t cr = rows[2][i] - 128;
+
+							r = _djv::jpegClamp((y + 91881 * cr + 32768) >> 16);
+							g = _djv::jpegClamp((y - 22554 * cb - 46802 * cr + 32768) >> 16);
+							b = _djv::jpegClamp((y + 116130 * cb + 32768) >> 16);
+						}
+
+						if (componentCount == 4)
+						{
+							// Adobe CMYK is stored inverted, YCCK encodes the inverted CMY channels
+
+							const int32_t k = rows[3][i];
+							if (_colorTransform == jpeg::ColorTransform::YCCK)
+							{
+								r = 255 - r;
+								g = 255 - g;
+								b = 255 - b;
+							}
+
+							r = (r * k + 127) / 255;
+							g = (g * k + 127) / 255;
+							b = (b * k + 127) / 255;
+						}
+
+						it[0] = r;
+						it[1] = g;
+						it[2] = b;
+					}
+				}
+			}
+
+			_rowsPos = 0;
+			_rowsEnd = rowCount * width * outputComponentCount;
+			++_mcuRow;
+		}
+
+		inline void JpegIStream::_decodeBlockBaseline(Component& component, int16_t* coefs)
+		{
+			const uint8_t dcSize = _decodeHuffman(_dcTables[component.dcTable]);
+			if (dcSize)
+			{
+				component.dcPred += _extend(_getBits(dcSize), dcSize);
+			}
+			coefs[0] = component.dcPred;
+
+			const HuffmanTable& acTable = _acTables[component.acTable];
+			for (uint8_t k = 1; k < 64;)
+			{
+				const uint8_t rs = _decodeHuffman(acTable);
+				const uint8_t r = rs >> 4;
+				const uint8_t s = rs & 15;
+
+				if (s)
+				{
+					k += r;
+					coefs[_zigzag[k]] = _extend(_getBits(s), s);
+					++k;
+				}
+				else if (r == 15)
+				{
+					k += 16;
+				}
+				else
+				{
+					break;
+				}
+			}
+		}
+
+		inline void JpegIStream::_decodeBlockDcFirst(Component& component, int16_t* coefs)
+		{
+			const uint8_t dcSize = _decodeHuffman(_dcTables[component.dcTable]);
+			if (dcSize)
+			{
+				component.dcPred += _extend(_getBits(dcSize), dcSize);
+			}
+			coefs[0] = component.dcPred * (1 << _approxLow);
+		}
+
+		inline void JpegIStream::_decodeBlockDcRefine(int16_t* coefs)
+		{
+			if (_getBit())
+			{
+				coefs[0] |= (1 << _approxLow);
+			}
+		}
+
+		inline void JpegIStream::_decodeBlockAcFirst(Component& component, int16_t* coefs)
+		{
+			if (_eobRun)
+			{
+				--_eobRun;
+				return;
+			}
+
+			const HuffmanTable& acTable = _acTables[component.acTable];
+			for (uint8_t k = _spectralStart; k <= _spectralEnd;)
+			{
+				const uint8_t rs = _decodeHuffman(acTable);
+				const uint8_t r = rs >> 4;
+				const uint8_t s = rs & 15;
+
+				if (s)
+				{
+					k += r;
+					coefs[_zigzag[k]] = _extend(_getBits(s), s) * (1 << _approxLow);
+					++k;
+				}
+				else if (r == 15)
+				{
+					k += 16;
+				}
+				else
+				{
+					_eobRun = (1 << r) - 1;
+					if (r)
+					{
+						_eobRun += _getBits(r);
+					}
+					break;
+				}
+			}
+		}
+
+		inline void JpegIStream::_decodeBlockAcRefine(Component& component, int16_t* coefs)
+		{
+			const int16_t p1 = 1 << _approxLow;
+			const int16_t m1 = -p1;
+
+			const auto refine = [&](int16_t& coef)
+			{
+				if (_getBit() && (coef & p1) == 0)
+				{
+					coef += (coef >= 0) ? p1 : m1;
+				}
+			};
+
+			uint8_t k = _spectralStart;
+
+			if (_eobRun == 0)
+			{
+				const HuffmanTable& acTable = _acTables[component.acTable];
+				for (; k <= _spectralEnd; ++k)
+				{
+					const uint8_t rs = _decodeHuffman(acTable);
+					int8_t r = rs >> 4;
+					int16_t value = 0;
+
+					if (rs & 15)
+					{
+						value = _getBit() ? p1 : m1;
+					}
+					else if (r != 15)
+					{
+						_eobRun = 1 << r;
+						if (r)
+						{
+							_eobRun += _getBits(r);
+						}
+						break;
+					}
+
+					// Skip r zero coefficients (refining the non-zero ones met on the way) then place the new value
+
+					for (; k <= _spectralEnd; ++k)
+					{
+						int16_t& coef = coefs[_zigzag[k]];
+						if (coef != 0)
+						{
+							refine(coef);
+						}
+						else if (--r < 0)
+						{
+							break;
+						}
+					}
+
+					if (value && k <= _spectralEnd)
+					{
+						coefs[_zigzag[k]] = value;
+					}
+				}
+			}
+
+			if (_eobRun)
+			{
+				for (; k <= _spectralEnd; ++k)
+				{
+					int16_t& coef = coefs[_zigzag[k]];
+					if (coef != 0)
+					{
+						refine(coef);
+					}
+				}
+
+				--_eobRun;
+			}
+		}
+
+		inline bool JpegIStream::_processRestart()
+		{
+			if (_restartInterval == 0)
+			{
+				return true;
+			}
+
+			if (_restartsLeft == 0)
+			{
+				// Drop the remaining bits of the interval and look for the RSTn marker that ends it
+
+				_bitBuffer = 0;
+				_bitCount = 0;
+
+				uint8_t marker;
+				if (!_readMarker(marker))
+				{
+					return false;
+				}
+				RUC_CHECK(_status, false, marker >= 0xD0 && marker <= 0xD7, std::format("Expected JPEG restart marker but instead got {}.", marker));
+
+				_eobRun = 0;
+				_restartsLeft = _restartInterval;
+				for (Component& component : _components)
+				{
+					component.dcPred = 0;
+				}
+			}
+
+			--_restartsLeft;
+
+			return true;
+		}
+
+		inline void JpegIStream::_fillBits()
+		{
+			while (_bitCount <= 56)
+			{
+				uint8_t byte = 0;
+
+				// Once a marker is met, the entropy-coded segment is over: the decoder is fed with zeros
+
+				if (!_pendingMarker)
+				{
+					_stream->read(&byte, 1);
+					if (byte == 0xFF)
+					{
+						uint8_t next = 0xFF;
+						while (next == 0xFF && _stream->getStatus())
+						{
+							_stream->read(&next, 1);
+						}
+
+						if (next != 0)
+						{
+							_pendingMarker = next;
+							byte = 0;
+						}
+					}
+
+					if (!_stream->getStatus())
+					{
+						_pendingMarker = 0xD9;
+						byte = 0;
+					}
+				}
+
+				_bitBuffer |= static_cast<uint64_t>(byte) << (56 - _bitCount);
+				_bitCount += 8;
+			}
+		}
+
+		inline uint32_t JpegIStream::_getBits(uint8_t count)
+		{
+			assert(count <= 16);
+
+			if (count == 0)
+			{
+				return 0;
+			}
+
+			if (_bitCount < count)
+			{
+				_fillBits();
+			}
+
+			const uint32_t value = _bitBuffer >> (64 - count);
+			_bitBuffer <<= count;
+			_bitCount -= count;
+
+			return value;
+		}
+
+		inline uint32_t JpegIStream::_getBit()
+		{
+			return _getBits(1);
+		}
+
+		inline uint8_t JpegIStream::_decodeHuffman(const HuffmanTable& table)
+		{
+			if (_bitCount < 16)
+			{
+				_fillBits();
+			}
+
+			const uint16_t entry = table.lookup[_bitBuffer >> (64 - 9)];
+			if (entry)
+			{
+				const uint8_t length = entry >> 8;
+				_bitBuffer <<= length;
+				_bitCount -= length;
+
+				return entry & 0xFF;
+			}
+
+			for (uint8_t length = 10; length <= 16; ++length)
+			{
+				const int32_t code = _bitBuffer >> (64 - length);
+				if (code <= table.maxCode[length])
+				{
+					_bitBuffer <<= length;
+					_bitCount -= length;
+
+					return table.values[code + table.valueOffset[length]];
+				}
+			}
+
+			// Corrupted data: like libjpeg, skip the bits and keep decoding with a null symbol
+
+			_bitBuffer <<= 16;
+			_bitCount -= 16;
+
+			return 0;
+		}
+
+		inline int32_t JpegIStream::_extend(uint32_t value, uint8_t size)
+		{
+			return (value < (1u << (size - 1))) ? static_cast<int32_t>(value) - (1 << size) + 1 : static_cast<int32_t>(value);
+		}
+
+		inline void JpegIStream::_buildHuffmanTable(HuffmanTable& table, const uint8_t* counts, const uint8_t* values)
+		{
+			std::fill_n(table.lookup, 1 << 9, 0);
+
+			int32_t code = 0;
+			int32_t k = 0;
+			for (uint8_t length = 1; length <= 16; ++length)
+			{
+				table.valueOffset[length] = k - code;
+				for (uint8_t i = 0; i < counts[length - 1]; ++i, ++code, ++k)
+				{
+					if (length <= 9)
+					{
+						const uint8_t shift = 9 - length;
+						std::fill_n(table.lookup + (code << shift), 1 << shift, (length << 8) | values[k]);
+					}
+				}
+
+				table.maxCode[length] = counts[length - 1] ? code - 1 : -1;
+				code <<= 1;
+			}
+
+			std::copy_n(values, k, table.values);
+		}
+
+		inline void JpegIStream::_idct(const int16_t* coefs, const uint16_t* quantTable, uint8_t* output, uint64_t stride, uint8_t blockSize) const
+		{
+			if (blockSize == 8)
+			{
+				alignas(32) int32_t block[64];
+				alignas(32) int32_t tmp[64];
+
+				for (uint8_t i = 0; i < 64; ++i)
+				{
+					block[i] = _djv::jpegDequantize(coefs[i], quantTable[i]);
+				}
+
+				// Columns, then rows after a transposition, so that both passes are vertical. Valid blocks stay far below
+				// 2^15 between the passes, the clamp only keeps corrupted ones from overflowing the second pass.
+
+				_djv::jpegIdctPass(block, tmp, 11);
+				for (uint8_t y = 0; y < 8; ++y)
+				{
+					for (uint8_t x = 0; x < 8; ++x)
+					{
+						block[x * 8 + y] = std::clamp<int32_t>(tmp[y * 8 + x], INT16_MIN, INT16_MAX);
+					}
+				}
+				_djv::jpegIdctPass(block, tmp, 18);
+
+				for (uint8_t y = 0; y < 8; ++y, output += stride)
+				{
+					for (uint8_t x = 0; x < 8; ++x)
+					{
+						output[x] = _djv::jpegClamp(tmp[x * 8 + y] + 128);
+					}
+				}
+			}
+			else if (blockSize == 1)
+			{
+				*output = _djv::jpegClamp(((_djv::jpegDequantize(coefs[0], quantTable[0]) + 4) >> 3) + 128);
+			}
+			else
+			{
+				// Reduced-size IDCT: the s*s lowest frequencies go through an s-point IDCT, which directly yields the
+				// block downscaled by 8/s (the DC term still gives the block mean).
+
+				const uint8_t s = blockSize;
+				const int32_t (&table)[4][4] = _scaledTables[s / 4];
+
+				int32_t tmp[4][4];
+				for (uint8_t y = 0; y < s; ++y)
+				{
+					for (uint8_t u = 0; u < s; ++u)
+					{
+						int32_t acc = 0;
+						for (uint8_t v = 0; v < s; ++v)
+						{
+							acc += table[y][v] * _djv::jpegDequantize(coefs[v * 8 + u], quantTable[v * 8 + u]);
+						}
+						tmp[y][u] = (acc + (1 << 9)) >> 10;
+					}
+				}
+
+				for (uint8_t y = 0; y < s; ++y, output += stride)
+				{
+					for (uint8_t x = 0; x < s; ++x)
+					{
+						int32_t acc = 0;
+						for (uint8_t u = 0; u < s; ++u)
+						{
+							acc += table[x][u] * tmp[y][u];
+						}
+						output[x] = _djv::jpegClamp(((acc + (1 << 15)) >> 16) + 128);
+					}
+				}
+			}
+		}
+	}
+}
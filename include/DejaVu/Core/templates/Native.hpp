@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace fmt
+	{
+		namespace native
+		{
+			template<CPixel TPixel>
+			constexpr Header createHeader(uint64_t width, uint64_t height)
+			{
+				using TComponent = typename TPixel::ComponentType;
+
+				Header header = {};
+
+				std::copy_n(signature, 8, header.signature);
+				header.version = version;
+				header.littleEndian = (std::endian::native == std::endian::little);
+				header.componentKind = std::floating_point<TComponent> ? ComponentKind::Float : (std::signed_integral<TComponent> ? ComponentKind::Signed : ComponentKind::Unsigned);
+				header.componentSize = sizeof(TComponent);
+				header.componentCount = TPixel::componentCount;
+				header.width = width;
+				header.height = height;
+				header.stride = width * sizeof(TPixel);
+				header.dataOffset = pageSize;
+
+				return header;
+			}
+
+			template<CPixel TPixel>
+			constexpr bool isCompatible(const Header& header)
+			{
+				// The sizes are checked by division first, so that a wrapped stride or pixel count cannot match
+
+				if (header.width == 0 || header.height == 0 || header.width > UINT64_MAX / sizeof(TPixel) / header.height)
+				{
+					return false;
+				}
+
+				const Header expected = createHeader<TPixel>(header.width, header.height);
+
+				return std::equal(header.signature, header.signature + 8, signature)
+					&& header.version == expected.version
+					&& header.littleEndian == expected.littleEndian
+					&& header.componentKind == expected.componentKind
+					&& header.componentSize == expected.componentSize
+					&& header.componentCount == expected.componentCount
+					&& header.stride == expected.stride
+					&& header.dataOffset >= sizeof(Header)
+					&& header.dataOffset % pageSize == 0
+					&& header.stride * header.height <= UINT64_MAX - header.dataOffset;
+			}
+		}
+	}
+}
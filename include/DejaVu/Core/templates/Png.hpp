@@ -0,0 +1,1584 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		constexpr uint16_t deflateLengthBases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		constexpr uint8_t deflateLengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		constexpr uint16_t deflateDistanceBases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		constexpr uint8_t deflateDistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+		constexpr uint8_t deflateCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		constexpr uint8_t pngAdam7[7][4] = {	// xStart, yStart, xStep, yStep
+			{ 0, 0, 8, 8 },
+			{ 4, 0, 8, 8 },
+			{ 0, 4, 4, 8 },
+			{ 2, 0, 4, 4 },
+			{ 0, 2, 2, 4 },
+			{ 1, 0, 2, 2 },
+			{ 0, 1, 1, 2 }
+		};
+
+		constexpr std::array<uint32_t, 256> pngCrcTable = []()
+		{
+			std::array<uint32_t, 256> table;
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t crc = i;
+				for (uint8_t k = 0; k < 8; ++k)
+				{
+					crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+				}
+				table[i] = crc;
+			}
+			return table;
+		}();
+
+		constexpr uint32_t pngChunkType(const char* name)
+		{
+			return (static_cast<uint32_t>(name[0]) << 24) | (static_cast<uint32_t>(name[1]) << 16) | (static_cast<uint32_t>(name[2]) << 8) | static_cast<uint32_t>(name[3]);
+		}
+
+		inline uint32_t pngCrc(uint32_t crc, const uint8_t* data, uint64_t size)
+		{
+			const uint8_t* const dataEnd = data + size;
+			for (; data != dataEnd; ++data)
+			{
+				crc = pngCrcTable[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+			}
+
+			return crc;
+		}
+
+		inline uint8_t pngPaeth(uint8_t a, uint8_t b, uint8_t c)
+		{
+			const int16_t pa = std::abs(b - c);
+			const int16_t pb = std::abs(a - c);
+			const int16_t pc = std::abs(a + b - 2 * c);
+
+			if (pa <= pb && pa <= pc)
+			{
+				return a;
+			}
+			else if (pb <= pc)
+			{
+				return b;
+			}
+			else
+			{
+				return c;
+			}
+		}
+
+		inline uint8_t pngPredict(uint8_t filter, uint8_t a, uint8_t b, uint8_t c)
+		{
+			switch (filter)
+			{
+				case 1:
+					return a;
+				case 2:
+					return b;
+				case 3:
+					return (a + b) >> 1;
+				case 4:
+					return pngPaeth(a, b, c);
+				default:
+					return 0;
+			}
+		}
+
+		inline uint16_t deflateReverseBits(uint16_t bits, uint8_t count)
+		{
+			uint16_t reversed = 0;
+			for (uint8_t i = 0; i < count; ++i, bits >>= 1)
+			{
+				reversed = (reversed << 1) | (bits & 1);
+			}
+
+			return reversed;
+		}
+	}
+
+	namespace fmt
+	{
+		inline PngIStream::PngIStream(dsk::IStream* stream) :
+			_stream(stream),
+			_status(),
+			_width(0),
+			_height(0),
+			_bitDepth(0),
+			_colorType(png::ColorType::Grayscale),
+			_interlaced(false),
+			_channelCount(0),
+			_bytesPerPixel(0),
+			_palette(),
+			_paletteSize(0),
+			_transparency(false),
+			_transparentColor(),
+			_idatRemaining(0),
+			_idatEnded(false),
+			_input(1 << 15),
+			_inputPos(0),
+			_inputEnd(0),
+			_bitBuffer(0),
+			_bitCount(0),
+			_inBlock(false),
+			_finalBlock(false),
+			_blockType(0),
+			_storedRemaining(0),
+			_matchLength(0),
+			_matchDistance(0),
+			_literalTable(),
+			_distanceTable(),
+			_window(1 << 15, 0),
+			_windowPos(0),
+			_totalOut(0),
+			_row(),
+			_previousRow(),
+			_samples(),
+			_samplesPos(0),
+			_samplesEnd(0),
+			_y(0)
+		{
+			assert(stream);
+		}
+
+		inline void PngIStream::readHeader(png::Header& header)
+		{
+			static constexpr uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+			uint8_t buffer[8];
+			if (!_read(buffer, 8))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, std::equal(buffer, buffer + 8, signature), "Invalid PNG signature.");
+
+			uint32_t length, type;
+			if (!_readChunkHeader(length, type))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, type == _djv::pngChunkType("IHDR"), "Expected PNG IHDR chunk at the beginning of the stream.");
+
+			if (!_readImageHeader(length))
+			{
+				return;
+			}
+
+			// Read chunks until the image data
+
+			while (true)
+			{
+				if (!_readChunkHeader(length, type))
+				{
+					return;
+				}
+
+				bool success = true;
+				if (type == _djv::pngChunkType("IDAT"))
+				{
+					_idatRemaining = length;
+					break;
+				}
+				else if (type == _djv::pngChunkType("PLTE"))
+				{
+					success = _readPalette(length);
+				}
+				else if (type == _djv::pngChunkType("tRNS"))
+				{
+					success = _readTransparency(length);
+				}
+				else
+				{
+					RUC_CHECK(_status, RUC_VOID, type != _djv::pngChunkType("IEND"), "PNG stream ends before its image data.");
+					success = _skipChunk(length);
+				}
+
+				if (!success)
+				{
+					return;
+				}
+			}
+
+			RUC_CHECK(_status, RUC_VOID, _colorType != png::ColorType::IndexedColor || _paletteSize != 0, "Indexed PNG image without PLTE chunk.");
+
+			// zlib header
+
+			uint32_t cmf, flg;
+			if (!_getBits(8, cmf) || !_getBits(8, flg))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, (cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0 && !(flg & 0x20), "Invalid zlib header in PNG image data.");
+
+			const uint64_t rowSize = (static_cast<uint64_t>(_width) * _channelCount * _bitDepth + 7) / 8;
+			_row.assign(rowSize + 1, 0);
+			_previousRow.assign(rowSize + 1, 0);
+			_samples.resize(static_cast<uint64_t>(_width) * getOutputComponentCount());
+
+			header.width = _width;
+			header.height = _height;
+			header.bitDepth = _bitDepth;
+			header.colorType = _colorType;
+			header.interlaced = _interlaced;
+		}
+
+		inline void PngIStream::readPixels(uint16_t* samples, uint64_t pixelCount)
+		{
+			assert(_width != 0);
+
+			const uint64_t rowSampleCount = static_cast<uint64_t>(_width) * getOutputComponentCount();
+			uint64_t sampleCount = pixelCount * getOutputComponentCount();
+			while (sampleCount)
+			{
+				if (_samplesPos == _samplesEnd)
+				{
+					RUC_CHECK(_status, RUC_VOID, _y < _height, "Trying to read more pixels than the PNG image contains.");
+
+					if (_interlaced)
+					{
+						if (!_deinterlace())
+						{
+							return;
+						}
+					}
+					else
+					{
+						if (!_readRow(_row.size() - 1))
+						{
+							return;
+						}
+						++_y;
+
+						// Whole rows are expanded directly in the caller's buffer
+
+						if (sampleCount >= rowSampleCount)
+						{
+							_expandRow(samples, _width);
+							samples += rowSampleCount;
+							sampleCount -= rowSampleCount;
+							continue;
+						}
+
+						_expandRow(_samples.data(), _width);
+						_samplesPos = 0;
+						_samplesEnd = rowSampleCount;
+					}
+				}
+
+				const uint64_t count = std::min(sampleCount, _samplesEnd - _samplesPos);
+				std::copy_n(_samples.data() + _samplesPos, count, samples);
+
+				samples += count;
+				_samplesPos += count;
+				sampleCount -= count;
+			}
+		}
+
+		inline uint8_t PngIStream::getOutputComponentCount() const
+		{
+			if (_colorType == png::ColorType::IndexedColor)
+			{
+				return 3 + _transparency;
+			}
+			else
+			{
+				return _channelCount + _transparency;
+			}
+		}
+
+		inline uint16_t PngIStream::getOutputMaxSampleValue() const
+		{
+			return (_colorType == png::ColorType::IndexedColor) ? 255 : (1 << _bitDepth) - 1;
+		}
+
+		inline const ruc::Status& PngIStream::getStatus() const
+		{
+			return _status;
+		}
+
+		inline bool PngIStream::_read(uint8_t* data, uint64_t size)
+		{
+			_stream->read(data, size);
+			RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+
+			return true;
+		}
+
+		inline bool PngIStream::_readChunkHeader(uint32_t& length, uint32_t& type)
+		{
+			uint8_t buffer[8];
+			if (!_read(buffer, 8))
+			{
+				return false;
+			}
+
+			length = (buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+			type = (buffer[4] << 24) | (buffer[5] << 16) | (buffer[6] << 8) | buffer[7];
+			RUC_CHECK(_status, false, length < (1u << 31), std::format("Invalid PNG chunk length {}.", length));
+
+			return true;
+		}
+
+		inline bool PngIStream::_skipChunk(uint32_t length)
+		{
+			uint64_t size = static_cast<uint64_t>(length) + 4;
+			while (size)
+			{
+				const uint64_t count = std::min<uint64_t>(size, _input.size());
+				if (!_read(_input.data(), count))
+				{
+					return false;
+				}
+				size -= count;
+			}
+
+			return true;
+		}
+
+		inline bool PngIStream::_readImageHeader(uint32_t length)
+		{
+			RUC_CHECK(_status, false, length == 13, std::format("Invalid PNG IHDR chunk length {}.", length));
+
+			uint8_t buffer[13 + 4];
+			if (!_read(buffer, 13 + 4))
+			{
+				return false;
+			}
+
+			_width = (buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+			_height = (buffer[4] << 24) | (buffer[5] << 16) | (buffer[6] << 8) | buffer[7];
+			_bitDepth = buffer[8];
+			_colorType = static_cast<png::ColorType>(buffer[9]);
+			_interlaced = buffer[12];
+
+			RUC_CHECK(_status, false, _width != 0 && _height != 0, "PNG image has a null size.");
+			RUC_CHECK(_status, false, buffer[10] == 0 && buffer[11] == 0 && buffer[12] <= 1, "Unknown PNG compression, filter or interlace method.");
+
+			bool validDepth = false;
+			switch (_colorType)
+			{
+				case png::ColorType::Grayscale:
+				{
+					validDepth = _bitDepth == 1 || _bitDepth == 2 || _bitDepth == 4 || _bitDepth == 8 || _bitDepth == 16;
+					_channelCount = 1;
+					break;
+				}
+				case png::ColorType::Truecolor:
+				{
+					validDepth = _bitDepth == 8 || _bitDepth == 16;
+					_channelCount = 3;
+					break;
+				}
+				case png::ColorType::IndexedColor:
+				{
+					validDepth = _bitDepth == 1 || _bitDepth == 2 || _bitDepth == 4 || _bitDepth == 8;
+					_channelCount = 1;
+					break;
+				}
+				case png::ColorType::GrayscaleAlpha:
+				{
+					validDepth = _bitDepth == 8 || _bitDepth == 16;
+					_channelCount = 2;
+					break;
+				}
+				case png::ColorType::TruecolorAlpha:
+				{
+					validDepth = _bitDepth == 8 || _bitDepth == 16;
+					_channelCount = 4;
+					break;
+				}
+				default:
+				{
+					RUC_CHECK(_status, false, false, std::format("Unknown PNG color type {}.", buffer[9]));
+				}
+			}
+			RUC_CHECK(_status, false, validDepth, std::format("Invalid PNG bit depth {} for color type {}.", _bitDepth, buffer[9]));
+
+			_bytesPerPixel = std::max(1, _channelCount * _bitDepth / 8);
+
+			return true;
+		}
+
+		inline bool PngIStream::_readPalette(uint32_t length)
+		{
+			RUC_CHECK(_status, false, length % 3 == 0 && length <= 3 * 256, std::format("Invalid PNG PLTE chunk length {}.", length));
+
+			uint8_t buffer[3 * 256 + 4];
+			if (!_read(buffer, length + 4))
+			{
+				return false;
+			}
+
+			_paletteSize = length / 3;
+			for (uint16_t i = 0; i < _paletteSize; ++i)
+			{
+				_palette[i][0] = buffer[3 * i];
+				_palette[i][1] = buffer[3 * i + 1];
+				_palette[i][2] = buffer[3 * i + 2];
+				_palette[i][3] = 255;
+			}
+
+			return true;
+		}
+
+		inline bool PngIStream::_readTransparency(uint32_t length)
+		{
+			uint8_t buffer[256 + 4];
+
+			switch (_colorType)
+			{
+				case png::ColorType::Grayscale:
+				{
+					RUC_CHECK(_status, false, length == 2, std::format("Invalid PNG tRNS chunk length {}.", length));
+					if (!_read(buffer, length + 4))
+					{
+						return false;
+					}
+
+					_transparentColor[0] = (buffer[0] << 8) | buffer[1];
+					break;
+				}
+				case png::ColorType::Truecolor:
+				{
+					RUC_CHECK(_status, false, length == 6, std::format("Invalid PNG tRNS chunk length {}.", length));
+					if (!_read(buffer, length + 4))
+					{
+						return false;
+					}
+
+					for (uint8_t i = 0; i < 3; ++i)
+					{
+						_transparentColor[i] = (buffer[2 * i] << 8) | buffer[2 * i + 1];
+					}
+					break;
+				}
+				case png::ColorType::IndexedColor:
+				{
+					RUC_CHECK(_status, false, length <= _paletteSize, std::format("Invalid PNG tRNS chunk length {}.", length));
+					if (!_read(buffer, length + 4))
+					{
+						return false;
+					}
+
+					for (uint16_t i = 0; i < length; ++i)
+					{
+						_palette[i][3] = buffer[i];
+					}
+					break;
+				}
+				default:
+				{
+					return _skipChunk(length);
+				}
+			}
+
+			_transparency = true;
+
+			return true;
+		}
+
+		inline bool PngIStream::_refillInput()
+		{
+			// IDAT chunks are concatenated, the image data ends at the first chunk of another type
+
+			while (_idatRemaining == 0)
+			{
+				if (_idatEnded)
+				{
+					return false;
+				}
+
+				uint8_t crc[4];
+				uint32_t length, type;
+				if (!_read(crc, 4) || !_readChunkHeader(length, type))
+				{
+					return false;
+				}
+
+				if (type != _djv::pngChunkType("IDAT"))
+				{
+					_idatEnded = true;
+					return false;
+				}
+
+				_idatRemaining = length;
+			}
+
+			const uint64_t size = std::min<uint64_t>(_idatRemaining, _input.size());
+			if (!_read(_input.data(), size))
+			{
+				return false;
+			}
+
+			_idatRemaining -= size;
+			_inputPos = 0;
+			_inputEnd = size;
+
+			return true;
+		}
+
+		inline void PngIStream::_fillBits()
+		{
+			while (_bitCount <= 56)
+			{
+				if (_inputPos == _inputEnd && !_refillInput())
+				{
+					return;
+				}
+
+				_bitBuffer |= static_cast<uint64_t>(_input[_inputPos++]) << _bitCount;
+				_bitCount += 8;
+			}
+		}
+
+		inline bool PngIStream::_getBits(uint8_t count, uint32_t& value)
+		{
+			if (_bitCount < count)
+			{
+				_fillBits();
+				RUC_CHECK(_status, false, _bitCount >= count, "Truncated PNG image data.");
+			}
+
+			value = _bitBuffer & ((1u << count) - 1);
+			_bitBuffer >>= count;
+			_bitCount -= count;
+
+			return true;
+		}
+
+		inline bool PngIStream::_decodeHuffman(const HuffmanTable& table, uint16_t& symbol)
+		{
+			if (_bitCount < 15)
+			{
+				_fillBits();
+			}
+
+			// Fast path for codes of 9 bits or less
+
+			const uint16_t entry = table.lookup[_bitBuffer & ((1 << 9) - 1)];
+			if (entry)
+			{
+				const uint8_t length = entry >> 9;
+				RUC_CHECK(_status, false, length <= _bitCount, "Truncated PNG image data.");
+
+				symbol = entry & ((1 << 9) - 1);
+				_bitBuffer >>= length;
+				_bitCount -= length;
+
+				return true;
+			}
+
+			// Canonical decoding, one bit at a time
+
+			int32_t code = 0;
+			int32_t first = 0;
+			int32_t index = 0;
+			uint64_t bits = _bitBuffer;
+			for (uint8_t length = 1; length < 16; ++length, bits >>= 1)
+			{
+				code |= bits & 1;
+				const int32_t count = table.counts[length];
+				if (code - count < first)
+				{
+					RUC_CHECK(_status, false, length <= _bitCount, "Truncated PNG image data.");
+
+					symbol = table.symbols[index + code - first];
+					_bitBuffer >>= length;
+					_bitCount -= length;
+
+					return true;
+				}
+
+				index += count;
+				first += count;
+				first <<= 1;
+				code <<= 1;
+			}
+
+			RUC_CHECK(_status, false, false, "Invalid Huffman code in PNG image data.");
+		}
+
+		inline bool PngIStream::_buildHuffmanTable(HuffmanTable& table, const uint8_t* lengths, uint16_t count)
+		{
+			std::fill_n(table.counts, 16, 0);
+			for (uint16_t i = 0; i < count; ++i)
+			{
+				++table.counts[lengths[i]];
+			}
+			table.counts[0] = 0;
+
+			int32_t left = 1;
+			for (uint8_t length = 1; length < 16; ++length)
+			{
+				left = (left << 1) - table.counts[length];
+				if (left < 0)
+				{
+					return false;
+				}
+			}
+
+			uint16_t offsets[16];
+			offsets[1] = 0;
+			for (uint8_t length = 1; length < 15; ++length)
+			{
+				offsets[length + 1] = offsets[length] + table.counts[length];
+			}
+
+			for (uint16_t i = 0; i < count; ++i)
+			{
+				if (lengths[i])
+				{
+					table.symbols[offsets[lengths[i]]++] = i;
+				}
+			}
+
+			// Deflate codes are read LSB first, hence the lookup table is indexed by bit-reversed codes
+
+			std::fill_n(table.lookup, 1 << 9, 0);
+
+			uint16_t code = 0;
+			uint16_t index = 0;
+			for (uint8_t length = 1; length <= 9; ++length, code <<= 1)
+			{
+				for (uint16_t i = 0; i < table.counts[length]; ++i, ++code, ++index)
+				{
+					for (uint16_t j = _djv::deflateReverseBits(code, length); j < (1 << 9); j += 1 << length)
+					{
+						table.lookup[j] = (length << 9) | table.symbols[index];
+					}
+				}
+			}
+
+			return true;
+		}
+
+		inline bool PngIStream::_readBlockHeader()
+		{
+			uint32_t header;
+			if (!_getBits(3, header))
+			{
+				return false;
+			}
+
+			_finalBlock = header & 1;
+			_blockType = header >> 1;
+
+			switch (_blockType)
+			{
+				case 0:
+				{
+					const uint8_t padding = _bitCount & 7;
+					_bitBuffer >>= padding;
+					_bitCount -= padding;
+
+					uint32_t length, complement;
+					if (!_getBits(16, length) || !_getBits(16, complement))
+					{
+						return false;
+					}
+					RUC_CHECK(_status, false, length == (~complement & 0xFFFF), "Invalid stored block length in PNG image data.");
+
+					_storedRemaining = length;
+					break;
+				}
+				case 1:
+				{
+					uint8_t lengths[288 + 30];
+					std::fill_n(lengths, 144, 8);
+					std::fill_n(lengths + 144, 112, 9);
+					std::fill_n(lengths + 256, 24, 7);
+					std::fill_n(lengths + 280, 8, 8);
+					std::fill_n(lengths + 288, 30, 5);
+
+					_buildHuffmanTable(_literalTable, lengths, 288);
+					_buildHuffmanTable(_distanceTable, lengths + 288, 30);
+					break;
+				}
+				case 2:
+				{
+					if (!_readDynamicTables())
+					{
+						return false;
+					}
+					break;
+				}
+				default:
+				{
+					RUC_CHECK(_status, false, false, "Invalid block type in PNG image data.");
+				}
+			}
+
+			_inBlock = true;
+
+			return true;
+		}
+
+		inline bool PngIStream::_readDynamicTables()
+		{
+			uint32_t literalCount, distanceCount, codeLengthCount;
+			if (!_getBits(5, literalCount) || !_getBits(5, distanceCount) || !_getBits(4, codeLengthCount))
+			{
+				return false;
+			}
+
+			literalCount += 257;
+			distanceCount += 1;
+			codeLengthCount += 4;
+			RUC_CHECK(_status, false, literalCount <= 286 && distanceCount <= 30, "Invalid dynamic Huffman header in PNG image data.");
+
+			uint8_t lengths[286 + 30] = {};
+			for (uint8_t i = 0; i < codeLengthCount; ++i)
+			{
+				uint32_t length;
+				if (!_getBits(3, length))
+				{
+					return false;
+				}
+				lengths[_djv::deflateCodeLengthOrder[i]] = length;
+			}
+
+			HuffmanTable codeLengthTable;
+			RUC_CHECK(_status, false, _buildHuffmanTable(codeLengthTable, lengths, 19), "Invalid code length code in PNG image data.");
+
+			const uint16_t totalCount = literalCount + distanceCount;
+			for (uint16_t i = 0; i < totalCount;)
+			{
+				uint16_t symbol;
+				if (!_decodeHuffman(codeLengthTable, symbol))
+				{
+					return false;
+				}
+
+				if (symbol < 16)
+				{
+					lengths[i++] = symbol;
+					continue;
+				}
+
+				uint8_t value = 0;
+				uint32_t repeat;
+				bool success;
+				if (symbol == 16)
+				{
+					RUC_CHECK(_status, false, i != 0, "Invalid code length repetition in PNG image data.");
+					value = lengths[i - 1];
+					success = _getBits(2, repeat);
+					repeat += 3;
+				}
+				else if (symbol == 17)
+				{
+					success = _getBits(3, repeat);
+					repeat += 3;
+				}
+				else
+				{
+					success = _getBits(7, repeat);
+					repeat += 11;
+				}
+
+				if (!success)
+				{
+					return false;
+				}
+				RUC_CHECK(_status, false, i + repeat <= totalCount, "Invalid code length repetition in PNG image data.");
+
+				std::fill_n(lengths + i, repeat, value);
+				i += repeat;
+			}
+
+			RUC_CHECK(_status, false, lengths[256] != 0, "Missing end-of-block code in PNG image data.");
+			RUC_CHECK(_status, false, _buildHuffmanTable(_literalTable, lengths, literalCount), "Invalid literal/length code in PNG image data.");
+			RUC_CHECK(_status, false, _buildHuffmanTable(_distanceTable, lengths + literalCount, distanceCount), "Invalid distance code in PNG image data.");
+
+			return true;
+		}
+
+		inline bool PngIStream::_readStoredBytes(uint8_t* data, uint64_t size)
+		{
+			for (; size && _bitCount >= 8; ++data, --size)
+			{
+				*data = _bitBuffer & 0xFF;
+				_bitBuffer >>= 8;
+				_bitCount -= 8;
+			}
+
+			while (size)
+			{
+				if (_inputPos == _inputEnd)
+				{
+					RUC_CHECK(_status, false, _refillInput(), "Truncated PNG image data.");
+				}
+
+				const uint64_t count = std::min(size, _inputEnd - _inputPos);
+				std::copy_n(_input.data() + _inputPos, count, data);
+
+				data += count;
+				size -= count;
+				_inputPos += count;
+			}
+
+			return true;
+		}
+
+		inline bool PngIStream::_inflate(uint8_t* data, uint64_t size)
+		{
+			constexpr uint16_t windowMask = (1 << 15) - 1;
+
+			while (size)
+			{
+				if (_matchLength)
+				{
+					const uint16_t count = std::min<uint64_t>(size, _matchLength);
+					for (uint16_t i = 0; i < count; ++i, ++data)
+					{
+						*data = _window[(_windowPos - _matchDistance) & windowMask];
+						_window[_windowPos] = *data;
+						_windowPos = (_windowPos + 1) & windowMask;
+					}
+
+					_matchLength -= count;
+					_totalOut += count;
+					size -= count;
+				}
+				else if (!_inBlock)
+				{
+					RUC_CHECK(_status, false, !_finalBlock, "PNG image data ends before the end of the image.");
+					if (!_readBlockHeader())
+					{
+						return false;
+					}
+				}
+				else if (_blockType == 0)
+				{
+					const uint16_t count = std::min<uint64_t>(size, _storedRemaining);
+					if (!_readStoredBytes(data, count))
+					{
+						return false;
+					}
+
+					for (uint16_t i = 0; i < count; ++i, ++data)
+					{
+						_window[_windowPos] = *data;
+						_windowPos = (_windowPos + 1) & windowMask;
+					}
+
+					_storedRemaining -= count;
+					_totalOut += count;
+					size -= count;
+
+					_inBlock = (_storedRemaining != 0);
+				}
+				else
+				{
+					uint16_t symbol;
+					if (!_decodeHuffman(_literalTable, symbol))
+					{
+						return false;
+					}
+
+					if (symbol < 256)
+					{
+						*data = symbol;
+						_window[_windowPos] = symbol;
+						_windowPos = (_windowPos + 1) & windowMask;
+
+						++data;
+						++_totalOut;
+						--size;
+					}
+					else if (symbol == 256)
+					{
+						_inBlock = false;
+					}
+					else
+					{
+						symbol -= 257;
+						RUC_CHECK(_status, false, symbol < 29, "Invalid length code in PNG image data.");
+
+						uint32_t extra;
+						if (!_getBits(_djv::deflateLengthExtraBits[symbol], extra))
+						{
+							return false;
+						}
+						_matchLength = _djv::deflateLengthBases[symbol] + extra;
+
+						if (!_decodeHuffman(_distanceTable, symbol))
+						{
+							return false;
+						}
+						RUC_CHECK(_status, false, symbol < 30, "Invalid distance code in PNG image data.");
+
+						if (!_getBits(_djv::deflateDistanceExtraBits[symbol], extra))
+						{
+							return false;
+						}
+						_matchDistance = _djv::deflateDistanceBases[symbol] + extra;
+						RUC_CHECK(_status, false, _matchDistance <= _totalOut, "Invalid distance in PNG image data.");
+					}
+				}
+			}
+
+			return true;
+		}
+
+		inline bool PngIStream::_readRow(uint64_t rowSize)
+		{
+			std::swap(_row, _previousRow);
+			if (!_inflate(_row.data(), rowSize + 1))
+			{
+				return false;
+			}
+
+			uint8_t* row = _row.data() + 1;
+			const uint8_t* previousRow = _previousRow.data() + 1;
+			const uint8_t bpp = _bytesPerPixel;
+
+			switch (_row[0])
+			{
+				case 0:
+				{
+					break;
+				}
+				case 1:
+				{
+					for (uint64_t i = bpp; i < rowSize; ++i)
+					{
+						row[i] += row[i - bpp];
+					}
+					break;
+				}
+				case 2:
+				{
+					for (uint64_t i = 0; i < rowSize; ++i)
+					{
+						row[i] += previousRow[i];
+					}
+					break;
+				}
+				case 3:
+				{
+					for (uint64_t i = 0; i < bpp && i < rowSize; ++i)
+					{
+						row[i] += previousRow[i] >> 1;
+					}
+					for (uint64_t i = bpp; i < rowSize; ++i)
+					{
+						row[i] += (row[i - bpp] + previousRow[i]) >> 1;
+					}
+					break;
+				}
+				case 4:
+				{
+					for (uint64_t i = 0; i < bpp && i < rowSize; ++i)
+					{
+						row[i] += previousRow[i];
+					}
+					for (uint64_t i = bpp; i < rowSize; ++i)
+					{
+						row[i] += _djv::pngPaeth(row[i - bpp], previousRow[i], previousRow[i - bpp]);
+					}
+					break;
+				}
+				default:
+				{
+					RUC_CHECK(_status, false, false, std::format("Invalid PNG filter type {}.", _row[0]));
+				}
+			}
+
+			return true;
+		}
+
+		inline void PngIStream::_expandRow(uint16_t* samples, uint64_t width) const
+		{
+			const uint8_t* row = _row.data() + 1;
+			const uint8_t outputCount = getOutputComponentCount();
+			const uint16_t maxValue = getOutputMaxSampleValue();
+
+			uint16_t values[4];
+			for (uint64_t i = 0; i < width; ++i, samples += outputCount)
+			{
+				if (_bitDepth == 8)
+				{
+					std::copy_n(row + i * _channelCount, _channelCount, values);
+				}
+				else if (_bitDepth == 16)
+				{
+					const uint8_t* it = row + 2 * i * _channelCount;
+					for (uint8_t k = 0; k < _channelCount; ++k, it += 2)
+					{
+						values[k] = (it[0] << 8) | it[1];
+					}
+				}
+				else
+				{
+					const uint64_t bit = i * _bitDepth;
+					values[0] = (row[bit / 8] >> (8 - _bitDepth - bit % 8)) & ((1 << _bitDepth) - 1);
+				}
+
+				if (_colorType == png::ColorType::IndexedColor)
+				{
+					std::copy_n(_palette[values[0]], outputCount, samples);
+				}
+				else
+				{
+					std::copy_n(values, _channelCount, samples);
+					if (_transparency)
+					{
+						samples[_channelCount] = std::equal(values, values + _channelCount, _transparentColor) ? 0 : maxValue;
+					}
+				}
+			}
+		}
+
+		inline bool PngIStream::_deinterlace()
+		{
+			// Adam7 passes are spread over the whole image, so it is decoded at once
+
+			const uint8_t outputCount = getOutputComponentCount();
+			std::vector<uint16_t> passSamples(_samples);
+			_samples.resize(static_cast<uint64_t>(_width) * _height * outputCount);
+
+			for (uint8_t pass = 0; pass < 7; ++pass)
+			{
+				const uint8_t* adam7 = _djv::pngAdam7[pass];
+				if (_width <= adam7[0] || _height <= adam7[1])
+				{
+					continue;
+				}
+
+				const uint64_t passWidth = (_width - adam7[0] + adam7[2] - 1) / adam7[2];
+				const uint64_t passHeight = (_height - adam7[1] + adam7[3] - 1) / adam7[3];
+				const uint64_t rowSize = (passWidth * _channelCount * _bitDepth + 7) / 8;
+
+				std::fill(_row.begin(), _row.end(), 0);
+				std::fill(_previousRow.begin(), _previousRow.end(), 0);
+
+				for (uint64_t j = 0; j < passHeight; ++j)
+				{
+					if (!_readRow(rowSize))
+					{
+						return false;
+					}
+					_expandRow(passSamples.data(), passWidth);
+
+					const uint16_t* itPass = passSamples.data();
+					uint16_t* it = _samples.data() + ((adam7[1] + j * adam7[3]) * _width + adam7[0]) * outputCount;
+					for (uint64_t i = 0; i < passWidth; ++i, itPass += outputCount, it += adam7[2] * outputCount)
+					{
+						std::copy_n(itPass, outputCount, it);
+					}
+				}
+			}
+
+			_samplesPos = 0;
+			_samplesEnd = _samples.size();
+			_y = _height;
+
+			return true;
+		}
+
+
+		inline PngOStream::PngOStream(dsk::OStream* stream) :
+			_stream(stream),
+			_status(),
+			_level(png::CompressionLevel::Fast),
+			_width(0),
+			_height(0),
+			_bitDepth(0),
+			_channelCount(0),
+			_bytesPerPixel(0),
+			_rowSize(0),
+			_row(),
+			_previousRow(),
+			_filtered(),
+			_rowPos(0),
+			_y(0),
+			_literalCodes(),
+			_literalLengths(),
+			_lengthSymbols(),
+			_history(),
+			_historyStart(0),
+			_historyEnd(0),
+			_hashHeads(),
+			_stored(),
+			_adler(),
+			_idat(),
+			_bitBuffer(0),
+			_bitCount(0)
+		{
+			assert(stream);
+
+			// Fixed Huffman codes, bit-reversed since deflate writes codes MSB first in an LSB first stream
+
+			for (uint16_t i = 0; i < 286; ++i)
+			{
+				if (i < 144)
+				{
+					_literalLengths[i] = 8;
+					_literalCodes[i] = _djv::deflateReverseBits(0x30 + i, 8);
+				}
+				else if (i < 256)
+				{
+					_literalLengths[i] = 9;
+					_literalCodes[i] = _djv::deflateReverseBits(0x190 + i - 144, 9);
+				}
+				else if (i < 280)
+				{
+					_literalLengths[i] = 7;
+					_literalCodes[i] = _djv::deflateReverseBits(i - 256, 7);
+				}
+				else
+				{
+					_literalLengths[i] = 8;
+					_literalCodes[i] = _djv::deflateReverseBits(0xC0 + i - 280, 8);
+				}
+			}
+
+			for (uint8_t i = 0; i < 29; ++i)
+			{
+				const uint16_t lengthEnd = std::min(_djv::deflateLengthBases[i] + (1 << _djv::deflateLengthExtraBits[i]), 259);
+				for (uint16_t length = _djv::deflateLengthBases[i]; length < lengthEnd; ++length)
+				{
+					_lengthSymbols[length - 3] = i;
+				}
+			}
+		}
+
+		inline void PngOStream::setCompressionLevel(png::CompressionLevel level)
+		{
+			assert(_width == 0);
+			_level = level;
+		}
+
+		inline void PngOStream::writeHeader(const png::Header& header)
+		{
+			assert(header.width != 0 && header.height != 0);
+			assert(header.bitDepth == 8 || header.bitDepth == 16);
+			assert(header.colorType != png::ColorType::IndexedColor);
+			assert(!header.interlaced);
+
+			_width = header.width;
+			_height = header.height;
+			_bitDepth = header.bitDepth;
+
+			switch (header.colorType)
+			{
+				case png::ColorType::Grayscale:
+					_channelCount = 1;
+					break;
+				case png::ColorType::GrayscaleAlpha:
+					_channelCount = 2;
+					break;
+				case png::ColorType::Truecolor:
+					_channelCount = 3;
+					break;
+				default:
+					_channelCount = 4;
+					break;
+			}
+
+			_bytesPerPixel = _channelCount * _bitDepth / 8;
+			_rowSize = static_cast<uint64_t>(_width) * _bytesPerPixel;
+
+			_row.assign(_rowSize, 0);
+			_previousRow.assign(_rowSize, 0);
+			_filtered.resize(_rowSize + 1);
+
+			if (_level == png::CompressionLevel::Store)
+			{
+				_stored.reserve(UINT16_MAX);
+			}
+			else
+			{
+				_history.resize(2 * _windowSize);
+				if (_level == png::CompressionLevel::Fast)
+				{
+					_hashHeads.assign(_hashSize, 0);
+				}
+			}
+
+			// Signature and IHDR
+
+			static constexpr uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			if (!_write(signature, 8))
+			{
+				return;
+			}
+
+			const uint8_t imageHeader[13] = {
+				static_cast<uint8_t>(_width >> 24), static_cast<uint8_t>(_width >> 16), static_cast<uint8_t>(_width >> 8), static_cast<uint8_t>(_width),
+				static_cast<uint8_t>(_height >> 24), static_cast<uint8_t>(_height >> 16), static_cast<uint8_t>(_height >> 8), static_cast<uint8_t>(_height),
+				_bitDepth, static_cast<uint8_t>(header.colorType), 0, 0, 0
+			};
+			if (!_writeChunk("IHDR", imageHeader, 13))
+			{
+				return;
+			}
+
+			// zlib header, then the first fixed Huffman block is opened for compressed levels
+
+			_idat.reserve(_idatSize + UINT16_MAX + 8);
+			_idat.push_back(0x78);
+			_idat.push_back(0x01);
+			_adler[0] = 1;
+			_adler[1] = 0;
+
+			if (_level != png::CompressionLevel::Store)
+			{
+				_putBits(2, 3);
+			}
+		}
+
+		inline void PngOStream::writePixels(const uint16_t* samples, uint64_t pixelCount)
+		{
+			assert(_width != 0);
+
+			uint64_t sampleCount = pixelCount * _channelCount;
+			while (sampleCount)
+			{
+				RUC_CHECK(_status, RUC_VOID, _y < _height, "Trying to write more pixels than the PNG image contains.");
+
+				const uint64_t count = std::min(sampleCount, (_rowSize - _rowPos) * 8 / _bitDepth);
+				uint8_t* it = _row.data() + _rowPos;
+				if (_bitDepth == 8)
+				{
+					for (uint64_t i = 0; i < count; ++i, ++it)
+					{
+						*it = samples[i];
+					}
+				}
+				else
+				{
+					for (uint64_t i = 0; i < count; ++i, it += 2)
+					{
+						it[0] = samples[i] >> 8;
+						it[1] = samples[i] & 0xFF;
+					}
+				}
+
+				samples += count;
+				sampleCount -= count;
+				_rowPos = it - _row.data();
+
+				if (_rowPos == _rowSize)
+				{
+					_filterRow();
+					if (!_deflate(_filtered.data(), _rowSize + 1))
+					{
+						return;
+					}
+
+					std::swap(_row, _previousRow);
+					_rowPos = 0;
+					++_y;
+
+					if (_y == _height && !_finish())
+					{
+						return;
+					}
+				}
+			}
+		}
+
+		inline const ruc::Status& PngOStream::getStatus() const
+		{
+			return _status;
+		}
+
+		inline bool PngOStream::_write(const uint8_t* data, uint64_t size)
+		{
+			_stream->write(data, size);
+			RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+
+			return true;
+		}
+
+		inline bool PngOStream::_writeChunk(const char* type, const uint8_t* data, uint32_t size)
+		{
+			const uint8_t header[8] = {
+				static_cast<uint8_t>(size >> 24), static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size),
+				static_cast<uint8_t>(type[0]), static_cast<uint8_t>(type[1]), static_cast<uint8_t>(type[2]), static_cast<uint8_t>(type[3])
+			};
+
+			const uint32_t crc = _djv::pngCrc(_djv::pngCrc(0xFFFFFFFF, header + 4, 4), data, size) ^ 0xFFFFFFFF;
+			const uint8_t footer[4] = { static_cast<uint8_t>(crc >> 24), static_cast<uint8_t>(crc >> 16), static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc) };
+
+			return _write(header, 8) && (size == 0 || _write(data, size)) && _write(footer, 4);
+		}
+
+		inline bool PngOStream::_writeIdat(bool force)
+		{
+			if (_idat.size() >= _idatSize || (force && !_idat.empty()))
+			{
+				if (!_writeChunk("IDAT", _idat.data(), _idat.size()))
+				{
+					return false;
+				}
+				_idat.clear();
+			}
+
+			return true;
+		}
+
+		inline void PngOStream::_putBits(uint32_t bits, uint8_t count)
+		{
+			_bitBuffer |= static_cast<uint64_t>(bits) << _bitCount;
+			_bitCount += count;
+
+			while (_bitCount >= 8)
+			{
+				_idat.push_back(_bitBuffer & 0xFF);
+				_bitBuffer >>= 8;
+				_bitCount -= 8;
+			}
+		}
+
+		inline void PngOStream::_alignBits()
+		{
+			if (_bitCount)
+			{
+				_idat.push_back(_bitBuffer & 0xFF);
+				_bitBuffer = 0;
+				_bitCount = 0;
+			}
+		}
+
+		inline void PngOStream::_putLiteral(uint16_t literal)
+		{
+			_putBits(_literalCodes[literal], _literalLengths[literal]);
+		}
+
+		inline void PngOStream::_putMatch(uint16_t length, uint16_t distance)
+		{
+			const uint8_t lengthSymbol = _lengthSymbols[length - 3];
+			_putBits(_literalCodes[257 + lengthSymbol], _literalLengths[257 + lengthSymbol]);
+			_putBits(length - _djv::deflateLengthBases[lengthSymbol], _djv::deflateLengthExtraBits[lengthSymbol]);
+
+			const uint16_t d = distance - 1;
+			uint8_t distanceSymbol = d;
+			uint8_t extraBits = 0;
+			if (d >= 4)
+			{
+				const uint8_t log = std::bit_width(d) - 1;
+				extraBits = log - 1;
+				distanceSymbol = 2 * log + ((d >> extraBits) & 1);
+			}
+
+			_putBits(_djv::deflateReverseBits(distanceSymbol, 5), 5);
+			_putBits(d & ((1 << extraBits) - 1), extraBits);
+		}
+
+		inline void PngOStream::_filterRow()
+		{
+			const uint8_t* row = _row.data();
+			const uint8_t* previousRow = _previousRow.data();
+			uint8_t* filtered = _filtered.data() + 1;
+
+			if (_level == png::CompressionLevel::Store)
+			{
+				_filtered[0] = 0;
+				std::copy_n(row, _rowSize, filtered);
+				return;
+			}
+
+			// Choose the filter minimizing the sum of absolute differences, as libpng does
+
+			uint64_t sums[5] = {};
+			for (uint64_t i = 0; i < _rowSize; ++i)
+			{
+				const uint8_t a = (i >= _bytesPerPixel) ? row[i - _bytesPerPixel] : 0;
+				const uint8_t c = (i >= _bytesPerPixel) ? previousRow[i - _bytesPerPixel] : 0;
+				for (uint8_t filter = 0; filter < 5; ++filter)
+				{
+					sums[filter] += std::abs(static_cast<int8_t>(row[i] - _djv::pngPredict(filter, a, previousRow[i], c)));
+				}
+			}
+
+			const uint8_t filter = std::distance(sums, std::min_element(sums, sums + 5));
+			_filtered[0] = filter;
+
+			for (uint64_t i = 0; i < _rowSize; ++i)
+			{
+				const uint8_t a = (i >= _bytesPerPixel) ? row[i - _bytesPerPixel] : 0;
+				const uint8_t c = (i >= _bytesPerPixel) ? previousRow[i - _bytesPerPixel] : 0;
+				filtered[i] = row[i] - _djv::pngPredict(filter, a, previousRow[i], c);
+			}
+		}
+
+		inline bool PngOStream::_deflate(const uint8_t* data, uint64_t size)
+		{
+			// Adler-32 of the uncompressed data
+
+			uint32_t a = _adler[0];
+			uint32_t b = _adler[1];
+			for (uint64_t i = 0; i < size;)
+			{
+				const uint64_t iEnd = std::min<uint64_t>(size, i + 5552);
+				for (; i < iEnd; ++i)
+				{
+					a += data[i];
+					b += a;
+				}
+				a %= 65521;
+				b %= 65521;
+			}
+			_adler[0] = a;
+			_adler[1] = b;
+
+			if (_level == png::CompressionLevel::Store)
+			{
+				while (size)
+				{
+					const uint64_t count = std::min<uint64_t>(size, UINT16_MAX - _stored.size());
+					_stored.insert(_stored.end(), data, data + count);
+					data += count;
+					size -= count;
+
+					if (_stored.size() == UINT16_MAX)
+					{
+						_putBits(0, 3);
+						_alignBits();
+
+						_idat.push_back(0xFF);
+						_idat.push_back(0xFF);
+						_idat.push_back(0x00);
+						_idat.push_back(0x00);
+						_idat.insert(_idat.end(), _stored.begin(), _stored.end());
+						_stored.clear();
+
+						if (!_writeIdat(false))
+						{
+							return false;
+						}
+					}
+				}
+			}
+			else
+			{
+				// The history keeps at least the last 32KB, matches never go beyond the data already received
+
+				while (size)
+				{
+					if (_historyEnd - _historyStart == 2 * _windowSize)
+					{
+						std::copy(_history.begin() + _windowSize, _history.end(), _history.begin());
+						_historyStart += _windowSize;
+					}
+
+					const uint64_t count = std::min<uint64_t>(size, 2 * _windowSize - (_historyEnd - _historyStart));
+					std::copy_n(data, count, _history.data() + (_historyEnd - _historyStart));
+					data += count;
+					size -= count;
+
+					_historyEnd += count;
+					_compress(_historyEnd - count, _historyEnd);
+
+					if (!_writeIdat(false))
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		inline void PngOStream::_compress(uint64_t pos, uint64_t end)
+		{
+			while (pos < end)
+			{
+				const uint8_t* current = _history.data() + (pos - _historyStart);
+				const uint16_t maxLength = std::min<uint64_t>(258, end - pos);
+
+				uint16_t length = 0;
+				uint16_t distance = 0;
+				if (maxLength >= 3)
+				{
+					if (_level == png::CompressionLevel::Rle)
+					{
+						if (pos > _historyStart)
+						{
+							while (length < maxLength && current[length] == current[-1])
+							{
+								++length;
+							}
+							distance = 1;
+						}
+					}
+					else
+					{
+						const uint32_t hash = ((current[0] << 10) ^ (current[1] << 5) ^ current[2]) & (_hashSize - 1);
+						const uint64_t candidate = _hashHeads[hash];
+						_hashHeads[hash] = pos + 1;
+
+						if (candidate > _historyStart && pos + 1 - candidate <= _windowSize)
+						{
+							distance = pos + 1 - candidate;
+							const uint8_t* match = current - distance;
+							while (length < maxLength && match[length] == current[length])
+							{
+								++length;
+							}
+						}
+					}
+				}
+
+				if (length >= 3)
+				{
+					_putMatch(length, distance);
+					pos += length;
+				}
+				else
+				{
+					_putLiteral(*current);
+					++pos;
+				}
+			}
+		}
+
+		inline bool PngOStream::_finish()
+		{
+			if (_level == png::CompressionLevel::Store)
+			{
+				_putBits(1, 3);
+				_alignBits();
+
+				const uint16_t size = _stored.size();
+				_idat.push_back(size & 0xFF);
+				_idat.push_back(size >> 8);
+				_idat.push_back(~size & 0xFF);
+				_idat.push_back((~size >> 8) & 0xFF);
+				_idat.insert(_idat.end(), _stored.begin(), _stored.end());
+				_stored.clear();
+			}
+			else
+			{
+				// Close the current block and end with an empty final block
+
+				_putLiteral(256);
+				_putBits(3, 3);
+				_putLiteral(256);
+				_alignBits();
+			}
+
+			_idat.push_back(_adler[1] >> 8);
+			_idat.push_back(_adler[1] & 0xFF);
+			_idat.push_back(_adler[0] >> 8);
+			_idat.push_back(_adler[0] & 0xFF);
+
+			return _writeIdat(true) && _writeChunk("IEND", nullptr, 0);
+		}
+	}
+}
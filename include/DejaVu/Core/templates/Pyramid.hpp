@@ -0,0 +1,314 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		template<CPixel TPixel>
+		constexpr void reducePyramidLevel(const TPixel* source, uint64_t sourceWidth, uint64_t sourceHeight, TPixel* destination, uint64_t width, uint64_t height, std::vector<float>& row)
+		{
+			using TComponent = typename TPixel::ComponentType;
+			constexpr uint8_t componentCount = TPixel::componentCount;
+			constexpr float weights[5] = { 1.f / 16, 4.f / 16, 6.f / 16, 4.f / 16, 1.f / 16 };
+
+			const uint64_t sourceRowSize = sourceWidth * componentCount;
+			const TComponent* itSource = &source[0][0];
+			TComponent* it = &destination[0][0];
+
+			row.resize(sourceRowSize);
+
+			for (uint64_t j = 0; j < height; ++j, it += width * componentCount)
+			{
+				// Vertical 5-tap blur of the five source rows around row 2j
+
+				const TComponent* rows[5];
+				for (int64_t t = 0; t < 5; ++t)
+				{
+					rows[t] = itSource + std::clamp<int64_t>(2 * j + t - 2, 0, sourceHeight - 1) * sourceRowSize;
+				}
+
+				for (uint64_t n = 0; n < sourceRowSize; ++n)
+				{
+					row[n] = weights[0] * rows[0][n] + weights[1] * rows[1][n] + weights[2] * rows[2][n] + weights[3] * rows[3][n] + weights[4] * rows[4][n];
+				}
+
+				// Horizontal 5-tap blur, only evaluated on the kept columns
+
+				for (uint64_t i = 0; i < width; ++i)
+				{
+					const float* itRow = row.data() + (2 * i) * componentCount;
+
+					if (i != 0 && 2 * i + 2 < sourceWidth)
+					{
+						for (uint8_t k = 0; k < componentCount; ++k)
+						{
+							const float value = weights[0] * itRow[k - 2 * componentCount] + weights[1] * itRow[k - componentCount] + weights[2] * itRow[k] + weights[3] * itRow[k + componentCount] + weights[4] * itRow[k + 2 * componentCount];
+							it[i * componentCount + k] = resamplingCast<TComponent>(value);
+						}
+					}
+					else
+					{
+						for (uint8_t k = 0; k < componentCount; ++k)
+						{
+							float value = 0.f;
+							for (int64_t t = 0; t < 5; ++t)
+							{
+								value += weights[t] * row[std::clamp<int64_t>(2 * i + t - 2, 0, sourceWidth - 1) * componentCount + k];
+							}
+							it[i * componentCount + k] = resamplingCast<TComponent>(value);
+						}
+					}
+				}
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void expandPyramidLevel(const TPixel* source, uint64_t sourceWidth, uint64_t sourceHeight, TPixel* destination, uint64_t width, uint64_t height, bool subtract, std::vector<float>& row)
+		{
+			using TComponent = typename TPixel::ComponentType;
+			constexpr uint8_t componentCount = TPixel::componentCount;
+
+			const uint64_t sourceRowSize = sourceWidth * componentCount;
+			const TComponent* itSource = &source[0][0];
+			TComponent* it = &destination[0][0];
+
+			row.resize(sourceRowSize);
+
+			// Even output samples take (1, 6, 1) / 8 of the source, odd ones (1, 1) / 2, which is the 5-tap kernel applied to the zero-stuffed level
+
+			for (uint64_t j = 0; j < height; ++j, it += width * componentCount)
+			{
+				const int64_t m = j / 2;
+				const TComponent* row0 = itSource + std::clamp<int64_t>(m - 1 + (j & 1), 0, sourceHeight - 1) * sourceRowSize;
+				const TComponent* row1 = itSource + std::clamp<int64_t>(m + (j & 1), 0, sourceHeight - 1) * sourceRowSize;
+				const TComponent* row2 = itSource + std::clamp<int64_t>(m + 1, 0, sourceHeight - 1) * sourceRowSize;
+
+				if (j & 1)
+				{
+					for (uint64_t n = 0; n < sourceRowSize; ++n)
+					{
+						row[n] = 0.5f * (row0[n] + row1[n]);
+					}
+				}
+				else
+				{
+					for (uint64_t n = 0; n < sourceRowSize; ++n)
+					{
+						row[n] = 0.125f * (row0[n] + row2[n]) + 0.75f * row1[n];
+					}
+				}
+
+				for (uint64_t i = 0; i < width; ++i)
+				{
+					const uint64_t x0 = std::clamp<int64_t>(static_cast<int64_t>(i / 2) - 1 + (i & 1), 0, sourceWidth - 1) * componentCount;
+					const uint64_t x1 = std::min<uint64_t>(i / 2 + (i & 1), sourceWidth - 1) * componentCount;
+					const uint64_t x2 = std::min<uint64_t>(i / 2 + 1, sourceWidth - 1) * componentCount;
+
+					// The expansion is rounded on its own, so that adding it back gives exactly what it was subtracted from
+
+					for (uint8_t k = 0; k < componentCount; ++k)
+					{
+						const float value = (i & 1) ? 0.5f * (row[x0 + k] + row[x1 + k]) : 0.125f * (row[x0 + k] + row[x2 + k]) + 0.75f * row[x1 + k];
+						const TComponent expansion = resamplingCast<TComponent>(value);
+						TComponent& component = it[i * componentCount + k];
+						component = subtract ? component - expansion : component + expansion;
+					}
+				}
+			}
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr ImagePyramid<TPixel>::ImagePyramid(const Image<TPixel>& image, uint64_t levelCount) : ImagePyramid<TPixel>(image, levelCount, PyramidType::Gaussian)
+	{
+	}
+
+	template<CPixel TPixel>
+	constexpr ImagePyramid<TPixel>::ImagePyramid(const Image<TPixel>& image, uint64_t levelCount, PyramidType type) :
+		_type(type),
+		_pixels(nullptr),
+		_levels(),
+		_laplacianPixels(nullptr),
+		_laplacianLevels(),
+		_levelCount(0),
+		_builtCount(0),
+		_row()
+	{
+		assert(image.isValid());
+		assert(levelCount != 0);
+
+		// Compute the size of every level
+
+		std::vector<std::pair<uint64_t, uint64_t>> sizes(1, { image.getWidth(), image.getHeight() });
+		while (sizes.size() < levelCount && (sizes.back().first > 1 || sizes.back().second > 1))
+		{
+			sizes.emplace_back((sizes.back().first + 1) / 2, (sizes.back().second + 1) / 2);
+		}
+		_levelCount = sizes.size();
+
+		// Allocate all levels at once and copy the base image, Laplacian levels in a type wide enough for differences
+
+		const uint64_t baseSize = image.getWidth() * image.getHeight();
+		if (_type == PyramidType::Gaussian)
+		{
+			_allocateLevels(sizes, _pixels, _levels);
+			std::copy_n(image.getData(), baseSize, _pixels);
+		}
+		else
+		{
+			_allocateLevels(sizes, _laplacianPixels, _laplacianLevels);
+
+			const ComponentType* itSource = &image.getData()[0][0];
+			typename LaplacianPixelType::ComponentType* it = &_laplacianPixels[0][0];
+			for (uint64_t n = 0; n < baseSize * componentCount; ++n)
+			{
+				it[n] = itSource[n];
+			}
+		}
+
+		if (_type == PyramidType::Gaussian || _levelCount == 1)
+		{
+			_builtCount = 1;
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr const Image<TPixel>& ImagePyramid<TPixel>::getLevel(uint64_t level)
+	{
+		assert(_type == PyramidType::Gaussian);
+		assert(level < _levelCount);
+
+		while (_builtCount <= level)
+		{
+			_buildLevel();
+		}
+
+		return *_levels[level];
+	}
+
+	template<CPixel TPixel>
+	constexpr const Image<typename ImagePyramid<TPixel>::LaplacianPixelType>& ImagePyramid<TPixel>::getLaplacianLevel(uint64_t level)
+	{
+		assert(_type == PyramidType::Laplacian);
+		assert(level < _levelCount);
+
+		while (_builtCount <= level)
+		{
+			_buildLevel();
+		}
+
+		return *_laplacianLevels[level];
+	}
+
+	template<CPixel TPixel>
+	constexpr void ImagePyramid<TPixel>::reconstruct(Image<TPixel>& image)
+	{
+		assert(_type == PyramidType::Laplacian);
+
+		getLaplacianLevel(_levelCount - 1);
+
+		Image<LaplacianPixelType> current(*_laplacianLevels.back());
+		for (uint64_t k = _levelCount - 1; k != 0; --k)
+		{
+			Image<LaplacianPixelType> next(*_laplacianLevels[k - 1]);
+			_djv::expandPyramidLevel(current.getData(), current.getWidth(), current.getHeight(), next.getData(), next.getWidth(), next.getHeight(), false, _row);
+			current = std::move(next);
+		}
+
+		// Reconstructed components are back in the range of the base image
+
+		image.createNew(current.getWidth(), current.getHeight());
+
+		const typename LaplacianPixelType::ComponentType* itSource = &current.getData()[0][0];
+		ComponentType* it = &image.getData()[0][0];
+		for (uint64_t n = 0; n < current.getWidth() * current.getHeight() * componentCount; ++n)
+		{
+			it[n] = static_cast<ComponentType>(itSource[n]);
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr uint64_t ImagePyramid<TPixel>::getLevelCount() const
+	{
+		return _levelCount;
+	}
+
+	template<CPixel TPixel>
+	constexpr PyramidType ImagePyramid<TPixel>::getType() const
+	{
+		return _type;
+	}
+
+	template<CPixel TPixel>
+	constexpr ImagePyramid<TPixel>::~ImagePyramid()
+	{
+		for (Image<TPixel>* level : _levels)
+		{
+			delete level;
+		}
+
+		for (Image<LaplacianPixelType>* level : _laplacianLevels)
+		{
+			delete level;
+		}
+
+		delete[] _pixels;
+		delete[] _laplacianPixels;
+	}
+
+	template<CPixel TPixel>
+	template<CPixel TLevelPixel>
+	constexpr void ImagePyramid<TPixel>::_allocateLevels(const std::vector<std::pair<uint64_t, uint64_t>>& sizes, TLevelPixel*& pixels, std::vector<Image<TLevelPixel>*>& levels)
+	{
+		uint64_t pixelCount = 0;
+		for (const std::pair<uint64_t, uint64_t>& size : sizes)
+		{
+			pixelCount += size.first * size.second;
+		}
+
+		pixels = new TLevelPixel[pixelCount];
+
+		TLevelPixel* it = pixels;
+		for (const std::pair<uint64_t, uint64_t>& size : sizes)
+		{
+			levels.push_back(Image<TLevelPixel>::constructAroundMemory(size.first, size.second, it));
+			it += size.first * size.second;
+		}
+	}
+
+	template<CPixel TPixel>
+	constexpr void ImagePyramid<TPixel>::_buildLevel()
+	{
+		const uint64_t k = _builtCount;
+
+		// Gaussian: level k is the reduction of level k - 1
+
+		if (_type == PyramidType::Gaussian)
+		{
+			const Image<TPixel>& source = *_levels[k - 1];
+			Image<TPixel>& level = *_levels[k];
+			_djv::reducePyramidLevel(source.getData(), source.getWidth(), source.getHeight(), level.getData(), level.getWidth(), level.getHeight(), _row);
+		}
+
+		// Laplacian: level k still holds its Gaussian image, reduce it into level k + 1 then subtract its expansion
+
+		else if (k + 1 < _levelCount)
+		{
+			Image<LaplacianPixelType>& level = *_laplacianLevels[k];
+			Image<LaplacianPixelType>& next = *_laplacianLevels[k + 1];
+			_djv::reducePyramidLevel(level.getData(), level.getWidth(), level.getHeight(), next.getData(), next.getWidth(), next.getHeight(), _row);
+			_djv::expandPyramidLevel(next.getData(), next.getWidth(), next.getHeight(), level.getData(), level.getWidth(), level.getHeight(), true, _row);
+		}
+
+		++_builtCount;
+	}
+}
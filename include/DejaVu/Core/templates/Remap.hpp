@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	inline RemapTable::RemapTable(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight, const RemapFunction& remapFunc, scp::BorderBehaviour borderBehaviour)
+	{
+		_init(width, height, sourceWidth, sourceHeight);
+
+		float x, y;
+		std::vector<Entry>::iterator it = _entries.begin();
+		for (uint64_t j = 0; j < _height; ++j)
+		{
+			for (uint64_t i = 0; i < _width; ++i, ++it)
+			{
+				remapFunc(i, j, x, y);
+				_setEntry(*it, x, y, borderBehaviour);
+			}
+		}
+	}
+
+	inline RemapTable::RemapTable(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight, const float* mapX, const float* mapY, scp::BorderBehaviour borderBehaviour)
+	{
+		assert(mapX);
+		assert(mapY);
+
+		_init(width, height, sourceWidth, sourceHeight);
+
+		for (Entry& entry : _entries)
+		{
+			_setEntry(entry, *(mapX++), *(mapY++), borderBehaviour);
+		}
+	}
+
+	inline uint64_t RemapTable::getWidth() const
+	{
+		return _width;
+	}
+
+	inline uint64_t RemapTable::getHeight() const
+	{
+		return _height;
+	}
+
+	inline uint64_t RemapTable::getSourceWidth() const
+	{
+		return _sourceWidth;
+	}
+
+	inline uint64_t RemapTable::getSourceHeight() const
+	{
+		return _sourceHeight;
+	}
+
+	inline void RemapTable::_init(uint64_t width, uint64_t height, uint64_t sourceWidth, uint64_t sourceHeight)
+	{
+		assert(width != 0);
+		assert(height != 0);
+		assert(sourceWidth != 0);
+		assert(sourceHeight != 0);
+		assert(sourceWidth * sourceHeight <= UINT32_MAX);
+
+		_width = width;
+		_height = height;
+		_sourceWidth = sourceWidth;
+		_sourceHeight = sourceHeight;
+		_entries.resize(_width * _height);
+	}
+
+	inline void RemapTable::_setEntry(Entry& entry, float x, float y, scp::BorderBehaviour borderBehaviour) const
+	{
+		const float w = static_cast<float>(_sourceWidth);
+		const float h = static_cast<float>(_sourceHeight);
+
+		// Bring the coordinates inside [0, w - 1] x [0, h - 1]. Periodic coordinates interpolate with the clamped neighbour at the seam.
+
+		if (!std::isfinite(x) || !std::isfinite(y))
+		{
+			entry = { 0, 0, 0, _outside };
+			return;
+		}
+
+		switch (borderBehaviour)
+		{
+			case scp::BorderBehaviour::Zero:
+			{
+				if (x < -0.5f || x >= w - 0.5f || y < -0.5f || y >= h - 0.5f)
+				{
+					entry = { 0, 0, 0, _outside };
+					return;
+				}
+				break;
+			}
+			case scp::BorderBehaviour::Periodic:
+			{
+				x -= std::floor(x / w) * w;
+				y -= std::floor(y / h) * h;
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+
+		x = std::clamp(x, 0.f, w - 1.f);
+		y = std::clamp(y, 0.f, h - 1.f);
+
+		// Fixed-point position of the top-left tap
+
+		const uint32_t xFixed = static_cast<uint32_t>(x * 256.f + 0.5f);
+		const uint32_t yFixed = static_cast<uint32_t>(y * 256.f + 0.5f);
+		uint64_t i = xFixed >> 8;
+		uint64_t j = yFixed >> 8;
+		uint8_t xFraction = xFixed & 255;
+		uint8_t yFraction = yFixed & 255;
+
+		if (i >= _sourceWidth - 1)
+		{
+			i = _sourceWidth - 1;
+			xFraction = 0;
+		}
+
+		if (j >= _sourceHeight - 1)
+		{
+			j = _sourceHeight - 1;
+			yFraction = 0;
+		}
+
+		entry.offset = j * _sourceWidth + i;
+		entry.xFraction = xFraction;
+		entry.yFraction = yFraction;
+		entry.flags = (xFraction != 0 ? _hasRight : 0) | (yFraction != 0 ? _hasBottom : 0);
+	}
+}
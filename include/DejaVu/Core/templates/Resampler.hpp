@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		constexpr ResamplingFilter toResamplingFilter(scp::InterpolationMethod method)
+		{
+			switch (method)
+			{
+				case scp::InterpolationMethod::Linear:
+					return ResamplingFilter::Linear;
+				case scp::InterpolationMethod::Cubic:
+					return ResamplingFilter::Cubic;
+				default:
+					return ResamplingFilter::Nearest;
+			}
+		}
+
+		inline float resamplingFilter(ResamplingFilter filter, float x)
+		{
+			x = std::abs(x);
+
+			switch (filter)
+			{
+				case ResamplingFilter::Linear:
+				{
+					return (x < 1.f) ? 1.f - x : 0.f;
+				}
+				case ResamplingFilter::Cubic:
+				{
+					if (x < 1.f)
+					{
+						return (1.5f * x - 2.5f) * x * x + 1.f;
+					}
+					else if (x < 2.f)
+					{
+						return ((-0.5f * x + 2.5f) * x - 4.f) * x + 2.f;
+					}
+					else
+					{
+						return 0.f;
+					}
+				}
+				case ResamplingFilter::Lanczos3:
+				{
+					if (x < 1e-5f)
+					{
+						return 1.f;
+					}
+					else if (x < 3.f)
+					{
+						const float px = std::numbers::pi_v<float> * x;
+						return 3.f * std::sin(px) * std::sin(px / 3.f) / (px * px);
+					}
+					else
+					{
+						return 0.f;
+					}
+				}
+				default:
+				{
+					return (x <= 0.5f) ? 1.f : 0.f;
+				}
+			}
+		}
+
+		inline float resamplingFilterRadius(ResamplingFilter filter)
+		{
+			switch (filter)
+			{
+				case ResamplingFilter::Linear:
+					return 1.f;
+				case ResamplingFilter::Cubic:
+					return 2.f;
+				case ResamplingFilter::Lanczos3:
+					return 3.f;
+				default:
+					return 0.5f;
+			}
+		}
+
+		inline void buildResamplingTable(ResamplingTable& table, uint64_t sourceSize, uint64_t size, ResamplingFilter filter)
+		{
+			const float scale = static_cast<float>(sourceSize) / size;
+
+			table.starts.resize(size);
+			table.counts.resize(size);
+
+			// Nearest neighbour picks a single source pixel
+
+			if (filter == ResamplingFilter::Nearest)
+			{
+				table.maxCount = 1;
+				table.weights.assign(size, 1.f);
+				for (uint64_t i = 0; i < size; ++i)
+				{
+					table.starts[i] = std::min<uint64_t>((i + 0.5f) * scale, sourceSize - 1);
+					table.counts[i] = 1;
+				}
+
+				return;
+			}
+
+			// When downsampling, the filter is stretched to cover every source pixel so that the result is not aliased
+
+			const float filterScale = std::max(scale, 1.f);
+			const float support = resamplingFilterRadius(filter) * filterScale;
+
+			table.maxCount = static_cast<uint32_t>(std::ceil(support)) * 2 + 1;
+			table.weights.assign(size * table.maxCount, 0.f);
+
+			for (uint64_t i = 0; i < size; ++i)
+			{
+				// Source pixel j covers [j, j + 1), the box filter weights it by its coverage of the destination footprint
+
+				const float center = (i + 0.5f) * scale;
+				int64_t first, last;
+				if (filter == ResamplingFilter::Box)
+				{
+					first = std::max<int64_t>(std::floor(center - support), 0);
+					last = std::min<int64_t>(std::ceil(center + support) - 1, sourceSize - 1);
+				}
+				else
+				{
+					first = std::max<int64_t>(std::ceil(center - 0.5f - support), 0);
+					last = std::min<int64_t>(std::floor(center - 0.5f + support), sourceSize - 1);
+				}
+
+				float* weights = table.weights.data() + i * table.maxCount;
+				float sum = 0.f;
+				for (int64_t j = first; j <= last; ++j)
+				{
+					if (filter == ResamplingFilter::Box)
+					{
+						weights[j - first] = std::max(std::min(j + 1.f, center + support) - std::max<float>(j, center - support), 0.f);
+					}
+					else
+					{
+						weights[j - first] = resamplingFilter(filter, (j + 0.5f - center) / filterScale);
+					}
+					sum += weights[j - first];
+				}
+
+				table.starts[i] = first;
+				table.counts[i] = last - first + 1;
+
+				if (sum != 0.f)
+				{
+					for (uint32_t t = 0; t < table.counts[i]; ++t)
+					{
+						weights[t] /= sum;
+					}
+				}
+			}
+		}
+
+		template<typename TComponent>
+		constexpr TComponent resamplingCast(float x)
+		{
+			if constexpr (std::integral<TComponent>)
+			{
+				return std::clamp<float>(std::round(x), std::numeric_limits<TComponent>::min(), std::numeric_limits<TComponent>::max());
+			}
+			else
+			{
+				return x;
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void downsampleBox(const TPixel* source, uint64_t sourceWidth, TPixel* destination, uint64_t width, uint64_t height, uint64_t xFactor, uint64_t yFactor)
+		{
+			using TComponent = typename TPixel::ComponentType;
+			constexpr uint8_t componentCount = TPixel::componentCount;
+
+			const uint64_t sourceRowSize = sourceWidth * componentCount;
+			const uint64_t rowSize = width * componentCount;
+			const TComponent* itSource = &source[0][0];
+			TComponent* it = &destination[0][0];
+
+			// 2x2 kernels for u8 and f32, the most common thumbnail case
+
+			if constexpr (std::same_as<TComponent, uint8_t> || std::same_as<TComponent, float>)
+			{
+				if (xFactor == 2 && yFactor == 2)
+				{
+					for (uint64_t j = 0; j < height; ++j, itSource += 2 * sourceRowSize, it += rowSize)
+					{
+						const TComponent* itRow0 = itSource;
+						const TComponent* itRow1 = itSource + sourceRowSize;
+
+						for (uint64_t i = 0; i < width; ++i, itRow0 += 2 * componentCount, itRow1 += 2 * componentCount)
+						{
+							for (uint8_t k = 0; k < componentCount; ++k)
+							{
+								if constexpr (std::same_as<TComponent, uint8_t>)
+								{
+									it[i * componentCount + k] = (itRow0[k] + itRow0[componentCount + k] + itRow1[k] + itRow1[componentCount + k] + 2) >> 2;
+								}
+								else
+								{
+									it[i * componentCount + k] = (itRow0[k] + itRow0[componentCount + k] + itRow1[k] + itRow1[componentCount + k]) * 0.25f;
+								}
+							}
+						}
+					}
+
+					return;
+				}
+			}
+
+			// Generic case, each destination row sums its yFactor source rows in a single pass over them
+
+			using TAccumulator = std::conditional_t<std::floating_point<TComponent>, float, std::conditional_t<sizeof(TComponent) == 1, int32_t, int64_t>>;
+			std::vector<TAccumulator> accumulator(rowSize);
+			const double invCount = 1.0 / (xFactor * yFactor);
+
+			for (uint64_t j = 0; j < height; ++j, it += rowSize)
+			{
+				std::fill(accumulator.begin(), accumulator.end(), TAccumulator(0));
+
+				for (uint64_t l = 0; l < yFactor; ++l, itSource += sourceRowSize)
+				{
+					const TComponent* itRow = itSource;
+					TAccumulator* itAcc = accumulator.data();
+
+					for (uint64_t i = 0; i < width; ++i, itAcc += componentCount)
+					{
+						for (uint64_t m = 0; m < xFactor; ++m, itRow += componentCount)
+						{
+							for (uint8_t k = 0; k < componentCount; ++k)
+							{
+								itAcc[k] += itRow[k];
+							}
+						}
+					}
+				}
+
+				for (uint64_t n = 0; n < rowSize; ++n)
+				{
+					if constexpr (std::floating_point<TComponent>)
+					{
+						it[n] = accumulator[n] * static_cast<float>(invCount);
+					}
+					else
+					{
+						it[n] = std::round(accumulator[n] * invCount);
+					}
+				}
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr StreamResampler<TPixel>::StreamResampler(uint64_t width, uint64_t height, ResamplingFilter filter) :
+			_width(width),
+			_height(height),
+			_filter(filter),
+			_destination(nullptr),
+			_sourceWidth(0),
+			_sourceHeight(0),
+			_xTable(),
+			_yTable(),
+			_sourceRow(),
+			_rows(),
+			_accumulator(),
+			_sourceY(0),
+			_y(0)
+		{
+			assert(width != 0);
+			assert(height != 0);
+		}
+
+		template<CPixel TPixel>
+		constexpr void StreamResampler<TPixel>::begin(TPixel* destination, uint64_t sourceWidth, uint64_t sourceHeight)
+		{
+			assert(destination);
+			assert(sourceWidth != 0);
+			assert(sourceHeight != 0);
+
+			_destination = destination;
+			_sourceWidth = sourceWidth;
+			_sourceHeight = sourceHeight;
+
+			buildResamplingTable(_xTable, _sourceWidth, _width, _filter);
+			buildResamplingTable(_yTable, _sourceHeight, _height, _filter);
+
+			_sourceRow.resize(_sourceWidth);
+			_rows.resize(_yTable.maxCount * _width * componentCount);
+			_accumulator.resize(_width * componentCount);
+			_sourceY = 0;
+			_y = 0;
+		}
+
+		template<CPixel TPixel>
+		constexpr TPixel* StreamResampler<TPixel>::getSourceRow()
+		{
+			return _sourceRow.data();
+		}
+
+		template<CPixel TPixel>
+		constexpr void StreamResampler<TPixel>::pushSourceRow()
+		{
+			pushSourceRow(_sourceRow.data());
+		}
+
+		template<CPixel TPixel>
+		constexpr void StreamResampler<TPixel>::pushSourceRow(const TPixel* row)
+		{
+			assert(_sourceY < _sourceHeight);
+
+			// Resample horizontally, only if the row contributes to a destination row
+
+			if (_y < _height && _sourceY >= _yTable.starts[_y])
+			{
+				_resampleRow(row, _rows.data() + (_sourceY % _yTable.maxCount) * _width * componentCount);
+			}
+
+			++_sourceY;
+
+			// Resample vertically every destination row whose source rows are all available
+
+			for (; _y < _height && _yTable.starts[_y] + _yTable.counts[_y] <= _sourceY; ++_y)
+			{
+				_emitRow();
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr uint64_t StreamResampler<TPixel>::getWidth() const
+		{
+			return _width;
+		}
+
+		template<CPixel TPixel>
+		constexpr uint64_t StreamResampler<TPixel>::getHeight() const
+		{
+			return _height;
+		}
+
+		template<CPixel TPixel>
+		constexpr void StreamResampler<TPixel>::_resampleRow(const TPixel* row, float* destination)
+		{
+			for (uint64_t i = 0; i < _width; ++i, destination += componentCount)
+			{
+				const TPixel* itSource = row + _xTable.starts[i];
+				const float* weights = _xTable.weights.data() + i * _xTable.maxCount;
+
+				float acc[componentCount] = {};
+				for (uint32_t t = 0; t < _xTable.counts[i]; ++t, ++itSource)
+				{
+					for (uint8_t k = 0; k < componentCount; ++k)
+					{
+						acc[k] += (*itSource)[k] * weights[t];
+					}
+				}
+
+				std::copy_n(acc, componentCount, destination);
+			}
+		}
+
+		template<CPixel TPixel>
+		constexpr void StreamResampler<TPixel>::_emitRow()
+		{
+			const uint64_t rowSize = _width * componentCount;
+			const float* weights = _yTable.weights.data() + _y * _yTable.maxCount;
+			float* acc = _accumulator.data();
+
+			// Whole rows are accumulated at once, every channel of every pixel in the same contiguous loop
+
+			for (uint32_t t = 0; t < _yTable.counts[_y]; ++t)
+			{
+				const float* row = _rows.data() + ((_yTable.starts[_y] + t) % _yTable.maxCount) * rowSize;
+				const float weight = weights[t];
+
+				if (t == 0)
+				{
+					for (uint64_t n = 0; n < rowSize; ++n)
+					{
+						acc[n] = row[n] * weight;
+					}
+				}
+				else
+				{
+					for (uint64_t n = 0; n < rowSize; ++n)
+					{
+						acc[n] += row[n] * weight;
+					}
+				}
+			}
+
+			TPixel* it = _destination + _y * _width;
+			for (uint64_t i = 0; i < _width; ++i, ++it, acc += componentCount)
+			{
+				for (uint8_t k = 0; k < componentCount; ++k)
+				{
+					(*it)[k] = resamplingCast<ComponentType>(acc[k]);
+				}
+			}
+		}
+	}
+}
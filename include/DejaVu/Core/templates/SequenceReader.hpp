@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	template<CPixel TPixel>
+	ImageSequenceReader<TPixel>::ImageSequenceReader(const std::vector<std::filesystem::path>& paths, uint32_t prefetchCount) :
+		_paths(paths),
+		_slots(),
+		_next(0),
+		_loadNext(0),
+		_loadEnd(0),
+		_threads(),
+		_mutex(),
+		_condition(),
+		_stopping(false)
+	{
+		_start(prefetchCount);
+	}
+
+	template<CPixel TPixel>
+	ImageSequenceReader<TPixel>::ImageSequenceReader(const std::filesystem::path& directory, uint32_t prefetchCount) :
+		_paths(),
+		_slots(),
+		_next(0),
+		_loadNext(0),
+		_loadEnd(0),
+		_threads(),
+		_mutex(),
+		_condition(),
+		_stopping(false)
+	{
+		std::error_code error;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error))
+		{
+			ImageFormat format;
+			if (entry.is_regular_file() && Image<TPixel>::_extensionToImageFormat(entry.path().extension(), format))
+			{
+				_paths.push_back(entry.path());
+			}
+		}
+
+		std::sort(_paths.begin(), _paths.end());
+
+		_start(prefetchCount);
+	}
+
+	template<CPixel TPixel>
+	const Image<TPixel>* ImageSequenceReader<TPixel>::next()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		// The previous frame is released, its slot is reused for the frame prefetchCount + 1 ahead of it
+
+		if (_next != 0)
+		{
+			_loadEnd = std::min<uint64_t>(_next - 1 + _slots.size(), _paths.size());
+			_condition.notify_all();
+		}
+
+		if (_next == _paths.size())
+		{
+			return nullptr;
+		}
+
+		Slot& slot = _slots[_next % _slots.size()];
+		_condition.wait(lock, [&]() { return slot.index == _next; });
+		++_next;
+
+		return &slot.image;
+	}
+
+	template<CPixel TPixel>
+	const std::vector<std::filesystem::path>& ImageSequenceReader<TPixel>::getPaths() const
+	{
+		return _paths;
+	}
+
+	template<CPixel TPixel>
+	uint64_t ImageSequenceReader<TPixel>::getFrameCount() const
+	{
+		return _paths.size();
+	}
+
+	template<CPixel TPixel>
+	uint64_t ImageSequenceReader<TPixel>::getFrameIndex() const
+	{
+		return _next;
+	}
+
+	template<CPixel TPixel>
+	ImageSequenceReader<TPixel>::~ImageSequenceReader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+
+		_condition.notify_all();
+
+		for (std::thread& thread : _threads)
+		{
+			thread.join();
+		}
+	}
+
+	template<CPixel TPixel>
+	void ImageSequenceReader<TPixel>::_start(uint32_t prefetchCount)
+	{
+		assert(prefetchCount != 0);
+
+		const uint32_t slotCount = prefetchCount + 1;
+		const uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, prefetchCount);
+
+		_slots.reserve(slotCount);
+		for (uint32_t i = 0; i < slotCount; ++i)
+		{
+			_slots.push_back({ Image<TPixel>(1, 1), std::vector<uint8_t>(), UINT64_MAX });
+		}
+
+		_loadEnd = std::min<uint64_t>(slotCount, _paths.size());
+
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			_threads.emplace_back(&ImageSequenceReader<TPixel>::_run, this);
+		}
+	}
+
+	template<CPixel TPixel>
+	void ImageSequenceReader<TPixel>::_run()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true)
+		{
+			_condition.wait(lock, [&]() { return _stopping || _loadNext < _loadEnd; });
+
+			if (_stopping)
+			{
+				return;
+			}
+
+			// Frames are taken in order, so the one the caller waits for is always the first to be loaded
+
+			const uint64_t index = _loadNext++;
+			Slot& slot = _slots[index % _slots.size()];
+
+			lock.unlock();
+			_load(slot, _paths[index]);
+			lock.lock();
+
+			slot.index = index;
+			_condition.notify_all();
+		}
+	}
+
+	template<CPixel TPixel>
+	void ImageSequenceReader<TPixel>::_load(Slot& slot, const std::filesystem::path& path)
+	{
+		// When the file cannot be read in memory, createFromFile reports the error in the image status
+
+		ImageFormat format;
+		uint64_t size;
+		if (Image<TPixel>::_extensionToImageFormat(path.extension(), format) && _readFile(path, slot.data, size))
+		{
+			MemoryIStream stream(slot.data.data(), size);
+			slot.image.createFromStream(stream.getStream(), format);
+		}
+		else
+		{
+			slot.image.createFromFile(path);
+		}
+	}
+
+	template<CPixel TPixel>
+	bool ImageSequenceReader<TPixel>::_readFile(const std::filesystem::path& path, std::vector<uint8_t>& data, uint64_t& size)
+	{
+		// The buffer only grows, frames of similar sizes end up reading into the same memory
+
+#ifdef DJV_POSIX
+		const int descriptor = ::open(path.c_str(), O_RDONLY);
+		if (descriptor == -1)
+		{
+			return false;
+		}
+
+		struct stat status;
+		if (fstat(descriptor, &status) == -1)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		size = status.st_size;
+		if (data.size() < size)
+		{
+			data.resize(size);
+		}
+
+		uint64_t done = 0;
+		while (done != size)
+		{
+			const ssize_t n = ::read(descriptor, data.data() + done, size - done);
+			if (n <= 0 && !(n == -1 && errno == EINTR))
+			{
+				break;
+			}
+			done += std::max<ssize_t>(n, 0);
+		}
+
+		::close(descriptor);
+
+		return done == size;
+#else
+		std::FILE* file = std::fopen(path.string().c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		std::fseek(file, 0, SEEK_END);
+		const long end = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+
+		if (end < 0)
+		{
+			std::fclose(file);
+			return false;
+		}
+
+		size = end;
+		if (data.size() < size)
+		{
+			data.resize(size);
+		}
+
+		const bool success = std::fread(data.data(), 1, size, file) == size;
+		std::fclose(file);
+
+		return success;
+#endif
+	}
+}
@@ -11,6 +11,40 @@
 
 namespace djv
 {
+	namespace _djv
+	{
+		constexpr int64_t isqrt(int64_t n)
+		{
+			assert(n >= 0);
+
+			int64_t r = std::sqrt(static_cast<double>(n));
+			while (r * r > n)
+			{
+				--r;
+			}
+			while ((r + 1) * (r + 1) <= n)
+			{
+				++r;
+			}
+
+			return r;
+		}
+
+		constexpr int64_t ellipseHalfWidth(int64_t rxSq, int64_t rySq, int64_t dy)
+		{
+			// Largest dx such that dx^2 / rx^2 + dy^2 / ry^2 < 1
+
+			return isqrt((rxSq * (rySq - dy * dy) - 1) / rySq);
+		}
+
+		constexpr int64_t ceilDiv(int64_t numerator, int64_t denominator)
+		{
+			assert(denominator > 0);
+
+			return (numerator >= 0) ? (numerator + denominator - 1) / denominator : -(-numerator / denominator);
+		}
+	}
+
 	constexpr ShapeThickRect::ShapeThickRect(int64_t left, int64_t top, uint64_t width, uint64_t height, uint64_t thickness) :
 		_left(left),
 		_top(top),
@@ -66,11 +100,74 @@ namespace djv
 		return r;
 	}
 
+	constexpr ShapeThickRect::SpanGenerator::SpanGenerator(int64_t left, int64_t top, uint64_t width, uint64_t height, uint64_t thickness, uint64_t clipWidth, uint64_t clipHeight) :
+		_left(left),
+		_right(left + width),
+		_innerLeft(left + thickness),
+		_innerRight(left + width - thickness),
+		_bandTop(top + thickness),
+		_bandBottom(top + height - thickness),
+
+		_y(std::max<int64_t>(top, 0)),
+		_yEnd(std::min<int64_t>(top + height, clipHeight)),
+		_clipWidth(clipWidth),
+		_second(false)
+	{
+		assert(width > 0);
+		assert(height > 0);
+		assert(thickness > 0 && thickness <= (width + 1) / 2 && thickness <= (height + 1) / 2);
+	}
+
+	constexpr bool ShapeThickRect::SpanGenerator::getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd)
+	{
+		while (_y < _yEnd)
+		{
+			y = _y;
+
+			// Rows between the top and bottom bands are made of two spans, unless they touch
+
+			if (_y < _bandTop || _y >= _bandBottom || _innerRight <= _innerLeft)
+			{
+				xBegin = _left;
+				xEnd = _right;
+				++_y;
+			}
+			else if (!_second)
+			{
+				xBegin = _left;
+				xEnd = _innerLeft;
+				_second = true;
+			}
+			else
+			{
+				xBegin = _innerRight;
+				xEnd = _right;
+				_second = false;
+				++_y;
+			}
+
+			xBegin = std::max<int64_t>(xBegin, 0);
+			xEnd = std::min<int64_t>(xEnd, _clipWidth);
+
+			if (xBegin < xEnd)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	constexpr ShapeThickRect::Generator ShapeThickRect::getGenerator() const
 	{
 		return ShapeThickRect::Generator(_left, _top, _width, _height, _thickness);
 	}
 
+	constexpr ShapeThickRect::SpanGenerator ShapeThickRect::getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const
+	{
+		return ShapeThickRect::SpanGenerator(_left, _top, _width, _height, _thickness, clipWidth, clipHeight);
+	}
+
 
 	constexpr ShapeCrown::ShapeCrown(int64_t xCenter, int64_t yCenter, uint64_t outerRadius, uint64_t innerRadius) :
 		_xCenter(xCenter),
@@ -113,13 +210,14 @@ namespace djv
 			}
 		}
 
+		if (_y > _ly)
+		{
+			return false;
+		}
+
 		x = _x;
 		y = _y;
 
-		dx = _cx - _x;
-		dy = _cy - _y;
-		dSq = dx * dx + dy * dy;
-
 		do
 		{
 			++_x;
@@ -131,7 +229,7 @@ namespace djv
 
 			if (_y > _ly)
 			{
-				return false;
+				break;
 			}
 
 			dx = _cx - _x;
@@ -142,11 +240,78 @@ namespace djv
 		return true;
 	}
 
+	constexpr ShapeCrown::SpanGenerator::SpanGenerator(int64_t xCenter, int64_t yCenter, uint64_t outerRadius, uint64_t innerRadius, uint64_t clipWidth, uint64_t clipHeight) :
+		_cx(xCenter),
+		_cy(yCenter),
+		_irSq(innerRadius * innerRadius),
+		_orSq(outerRadius * outerRadius),
+
+		_y(std::max<int64_t>(yCenter - static_cast<int64_t>(outerRadius) + 1, 0)),
+		_yEnd(std::min<int64_t>(yCenter + static_cast<int64_t>(outerRadius), clipHeight)),
+		_clipWidth(clipWidth),
+		_secondBegin(0),
+		_secondEnd(0),
+		_second(false)
+	{
+		assert(innerRadius != outerRadius);
+	}
+
+	constexpr bool ShapeCrown::SpanGenerator::getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd)
+	{
+		while (_second || _y < _yEnd)
+		{
+			if (_second)
+			{
+				y = _y - 1;
+				xBegin = _secondBegin;
+				xEnd = _secondEnd;
+				_second = false;
+			}
+			else
+			{
+				// Pixels at squared distance d from the center are kept if irSq <= d < orSq
+
+				const int64_t dySq = (_cy - _y) * (_cy - _y);
+				const int64_t outer = _djv::isqrt(_orSq - dySq - 1);
+
+				y = _y;
+				xBegin = _cx - outer;
+				xEnd = _cx + outer + 1;
+
+				if (_irSq > dySq)
+				{
+					const int64_t inner = _djv::isqrt(_irSq - dySq - 1);
+					_secondBegin = std::max<int64_t>(_cx + inner + 1, 0);
+					_secondEnd = std::min<int64_t>(xEnd, _clipWidth);
+					_second = (_secondBegin < _secondEnd);
+					xEnd = _cx - inner;
+				}
+
+				++_y;
+			}
+
+			xBegin = std::max<int64_t>(xBegin, 0);
+			xEnd = std::min<int64_t>(xEnd, _clipWidth);
+
+			if (xBegin < xEnd)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	constexpr ShapeCrown::Generator ShapeCrown::getGenerator() const
 	{
 		return ShapeCrown::Generator(_xCenter, _yCenter, _outerRadius, _innerRadius);
 	}
 
+	constexpr ShapeCrown::SpanGenerator ShapeCrown::getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const
+	{
+		return ShapeCrown::SpanGenerator(_xCenter, _yCenter, _outerRadius, _innerRadius, clipWidth, clipHeight);
+	}
+
 
 	constexpr ShapeLine::ShapeLine(int64_t xStart, int64_t yStart, int64_t xEnd, int64_t yEnd) :
 		_xStart(xStart),
@@ -230,11 +395,305 @@ namespace djv
 		return true;
 	}
 
+	constexpr ShapeLine::SpanGenerator::SpanGenerator(int64_t xStart, int64_t yStart, int64_t xEnd, int64_t yEnd, uint64_t clipWidth, uint64_t clipHeight) :
+		_generator(xStart, yStart, xEnd, yEnd),
+		_clipWidth(clipWidth),
+		_clipHeight(clipHeight),
+		_x(0),
+		_y(0),
+		_pending(false),
+		_culled(std::max(xStart, xEnd) < 0 || std::max(yStart, yEnd) < 0 || std::min(xStart, xEnd) >= int64_t(clipWidth) || std::min(yStart, yEnd) >= int64_t(clipHeight))
+	{
+	}
+
+	constexpr bool ShapeLine::SpanGenerator::getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd)
+	{
+		if (_culled)
+		{
+			return false;
+		}
+
+		while (_pending || _generator.getNextPixel(_x, _y))
+		{
+			// Extend the run while the next pixel is on the same row, right after it
+
+			y = _y;
+			xBegin = _x;
+			xEnd = _x + 1;
+
+			_pending = false;
+			while (_generator.getNextPixel(_x, _y))
+			{
+				if (_y != y || _x != xEnd)
+				{
+					_pending = true;
+					break;
+				}
+
+				++xEnd;
+			}
+
+			if (y >= 0 && y < _clipHeight)
+			{
+				xBegin = std::max<int64_t>(xBegin, 0);
+				xEnd = std::min<int64_t>(xEnd, _clipWidth);
+
+				if (xBegin < xEnd)
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
 	constexpr ShapeLine::Generator ShapeLine::getGenerator() const
 	{
 		return ShapeLine::Generator(_xStart, _yStart, _xEnd, _yEnd);
 	}
 
+	constexpr ShapeLine::SpanGenerator ShapeLine::getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const
+	{
+		return ShapeLine::SpanGenerator(_xStart, _yStart, _xEnd, _yEnd, clipWidth, clipHeight);
+	}
+
+
+	constexpr ShapePolygon::ShapePolygon(const std::vector<std::array<int64_t, 2>>& vertices) :
+		_vertices(vertices)
+	{
+	}
+
+	constexpr ShapePolygon::SpanGenerator::SpanGenerator(const std::vector<std::array<int64_t, 2>>& vertices, uint64_t clipWidth, uint64_t clipHeight) :
+		SpanGenerator(vertices, 0, 0, clipWidth, clipHeight)
+	{
+	}
+
+	constexpr ShapePolygon::SpanGenerator::SpanGenerator(const std::vector<std::array<int64_t, 2>>& vertices, int64_t clipLeft, int64_t clipTop, int64_t clipRight, int64_t clipBottom) :
+		_edges(),
+		_activeEdges(),
+		_crossings(),
+		_nextEdge(0),
+		_crossing(0),
+		_clipLeft(clipLeft),
+		_clipRight(clipRight),
+		_row(0),
+		_rowEnd(0),
+		_y(0)
+	{
+		// Edge from (x0, y0) to (x1, y1), y0 < y1, crosses the center of the pixels of rows [y0, y1) at x0 + (y + 0.5 - y0) * dx / dy
+
+		_edges.reserve(vertices.size());
+		for (uint64_t i = 0; i < vertices.size(); ++i)
+		{
+			std::array<int64_t, 2> a = vertices[i];
+			std::array<int64_t, 2> b = vertices[(i + 1) % vertices.size()];
+
+			if (a[1] == b[1])
+			{
+				continue;
+			}
+			else if (a[1] > b[1])
+			{
+				std::swap(a, b);
+			}
+
+			const int64_t dx = b[0] - a[0];
+			const int64_t dy = b[1] - a[1];
+			_edges.push_back({ a[1], b[1], 2 * a[0] * dy + dx - dy, 2 * dx, 2 * dy });
+		}
+
+		if (_edges.empty())
+		{
+			return;
+		}
+
+		std::sort(_edges.begin(), _edges.end(), [](const Edge& a, const Edge& b) { return a.yBegin < b.yBegin; });
+
+		_row = std::max(_edges.front().yBegin, clipTop);
+		int64_t yMax = _edges.front().yEnd;
+		for (const Edge& edge : _edges)
+		{
+			yMax = std::max(yMax, edge.yEnd);
+		}
+		_rowEnd = std::min(yMax, clipBottom);
+	}
+
+	constexpr bool ShapePolygon::SpanGenerator::getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd)
+	{
+		while (true)
+		{
+			while (_crossing + 1 < _crossings.size())
+			{
+				xBegin = std::max(_crossings[_crossing], _clipLeft);
+				xEnd = std::min(_crossings[_crossing + 1], _clipRight);
+				_crossing += 2;
+
+				if (xBegin < xEnd)
+				{
+					y = _y;
+					return true;
+				}
+			}
+
+			if (_row >= _rowEnd)
+			{
+				return false;
+			}
+
+			// Update the active edge table, edges starting above the clip area are moved directly to the current row
+
+			for (; _nextEdge < _edges.size() && _edges[_nextEdge].yBegin <= _row; ++_nextEdge)
+			{
+				Edge edge = _edges[_nextEdge];
+				edge.numerator += (_row - edge.yBegin) * edge.step;
+				_activeEdges.push_back(edge);
+			}
+
+			std::erase_if(_activeEdges, [&](const Edge& edge) { return edge.yEnd <= _row; });
+
+			// Pixels between the 2k-th and the (2k+1)-th crossings are inside
+
+			_crossings.clear();
+			for (Edge& edge : _activeEdges)
+			{
+				_crossings.push_back(_djv::ceilDiv(edge.numerator, edge.denominator));
+				edge.numerator += edge.step;
+			}
+			std::sort(_crossings.begin(), _crossings.end());
+
+			_crossing = 0;
+			_y = _row;
+			++_row;
+		}
+	}
+
+	constexpr ShapePolygon::Generator::Generator(const std::vector<std::array<int64_t, 2>>& vertices) :
+		_spanGenerator(vertices, INT64_MIN, INT64_MIN, INT64_MAX, INT64_MAX),
+		_x(0),
+		_xEnd(0),
+		_y(0)
+	{
+	}
+
+	constexpr bool ShapePolygon::Generator::getNextPixel(int64_t& x, int64_t& y)
+	{
+		if (_x == _xEnd && !_spanGenerator.getNextSpan(_y, _x, _xEnd))
+		{
+			return false;
+		}
+
+		x = _x;
+		y = _y;
+		++_x;
+
+		return true;
+	}
+
+	constexpr ShapePolygon::Generator ShapePolygon::getGenerator() const
+	{
+		return ShapePolygon::Generator(_vertices);
+	}
+
+	constexpr ShapePolygon::SpanGenerator ShapePolygon::getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const
+	{
+		return ShapePolygon::SpanGenerator(_vertices, clipWidth, clipHeight);
+	}
+
+
+	constexpr ShapeEllipse::ShapeEllipse(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY) :
+		_xCenter(xCenter),
+		_yCenter(yCenter),
+		_radiusX(radiusX),
+		_radiusY(radiusY)
+	{
+	}
+
+	constexpr ShapeEllipse::Generator::Generator(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY) :
+		_cx(xCenter),
+		_cy(yCenter),
+		_rxSq(radiusX * radiusX),
+		_rySq(radiusY * radiusY),
+		_x(0),
+		_xEnd(0),
+		_y(0),
+		_yNext(yCenter - static_cast<int64_t>(radiusY) + 1),
+		_yEnd(yCenter + static_cast<int64_t>(radiusY))
+	{
+		if (radiusX == 0 || radiusY == 0)
+		{
+			_yEnd = _yNext;
+		}
+	}
+
+	constexpr bool ShapeEllipse::Generator::getNextPixel(int64_t& x, int64_t& y)
+	{
+		if (_x == _xEnd)
+		{
+			if (_yNext >= _yEnd)
+			{
+				return false;
+			}
+
+			const int64_t halfWidth = _djv::ellipseHalfWidth(_rxSq, _rySq, _cy - _yNext);
+			_x = _cx - halfWidth;
+			_xEnd = _cx + halfWidth + 1;
+			_y = _yNext;
+			++_yNext;
+		}
+
+		x = _x;
+		y = _y;
+		++_x;
+
+		return true;
+	}
+
+	constexpr ShapeEllipse::SpanGenerator::SpanGenerator(int64_t xCenter, int64_t yCenter, uint64_t radiusX, uint64_t radiusY, uint64_t clipWidth, uint64_t clipHeight) :
+		_cx(xCenter),
+		_cy(yCenter),
+		_rxSq(radiusX * radiusX),
+		_rySq(radiusY * radiusY),
+		_y(std::max<int64_t>(yCenter - static_cast<int64_t>(radiusY) + 1, 0)),
+		_yEnd(std::min<int64_t>(yCenter + static_cast<int64_t>(radiusY), clipHeight)),
+		_clipWidth(clipWidth)
+	{
+		if (radiusX == 0 || radiusY == 0)
+		{
+			_yEnd = _y;
+		}
+	}
+
+	constexpr bool ShapeEllipse::SpanGenerator::getNextSpan(int64_t& y, int64_t& xBegin, int64_t& xEnd)
+	{
+		while (_y < _yEnd)
+		{
+			const int64_t halfWidth = _djv::ellipseHalfWidth(_rxSq, _rySq, _cy - _y);
+
+			y = _y;
+			xBegin = std::max<int64_t>(_cx - halfWidth, 0);
+			xEnd = std::min<int64_t>(_cx + halfWidth + 1, _clipWidth);
+			++_y;
+
+			if (xBegin < xEnd)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	constexpr ShapeEllipse::Generator ShapeEllipse::getGenerator() const
+	{
+		return ShapeEllipse::Generator(_xCenter, _yCenter, _radiusX, _radiusY);
+	}
+
+	constexpr ShapeEllipse::SpanGenerator ShapeEllipse::getSpanGenerator(uint64_t clipWidth, uint64_t clipHeight) const
+	{
+		return ShapeEllipse::SpanGenerator(_xCenter, _yCenter, _radiusX, _radiusY, clipWidth, clipHeight);
+	}
+
 
 	constexpr ShapeFilledRect::ShapeFilledRect(int64_t left, int64_t top, uint64_t width, uint64_t height) : ShapeThickRect(left, top, width, height, std::min((width + 1) / 2, (height + 1) / 2))
 	{
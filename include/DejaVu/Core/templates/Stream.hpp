@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		inline uint64_t read(void* handle, uint8_t* data, uint64_t size)
+		{
+			return std::fread(data, 1, size, reinterpret_cast<std::FILE*>(handle));
+		}
+
+		inline bool eof(void* handle)
+		{
+			return std::feof(reinterpret_cast<std::FILE*>(handle));
+		}
+
+		inline uint64_t write(void* handle, const uint8_t* data, uint64_t size)
+		{
+			return std::fwrite(data, 1, size, reinterpret_cast<std::FILE*>(handle));
+		}
+	}
+
+	inline MemoryIStream::MemoryIStream(const uint8_t* data, uint64_t size) :
+		_data(data),
+		_size(size),
+		_position(0),
+		_stream(new dsk::IStream(this, &MemoryIStream::_read, &MemoryIStream::_eof))
+	{
+		assert(data || size == 0);
+	}
+
+	inline dsk::IStream* MemoryIStream::getStream()
+	{
+		return _stream;
+	}
+
+	inline uint64_t MemoryIStream::getPosition() const
+	{
+		return _position;
+	}
+
+	inline MemoryIStream::~MemoryIStream()
+	{
+		delete _stream;
+	}
+
+	inline uint64_t MemoryIStream::_read(void* handle, uint8_t* data, uint64_t size)
+	{
+		MemoryIStream* stream = reinterpret_cast<MemoryIStream*>(handle);
+
+		// Copy directly from the caller's span, there is no intermediate buffer
+
+		size = std::min(size, stream->_size - stream->_position);
+		std::copy_n(stream->_data + stream->_position, size, data);
+		stream->_position += size;
+
+		return size;
+	}
+
+	inline bool MemoryIStream::_eof(void* handle)
+	{
+		const MemoryIStream* stream = reinterpret_cast<const MemoryIStream*>(handle);
+		return stream->_position == stream->_size;
+	}
+
+	inline MemoryOStream::MemoryOStream(std::vector<uint8_t>& buffer) :
+		_buffer(&buffer),
+		_stream(new dsk::OStream(this, &MemoryOStream::_write))
+	{
+	}
+
+	inline dsk::OStream* MemoryOStream::getStream()
+	{
+		return _stream;
+	}
+
+	inline MemoryOStream::~MemoryOStream()
+	{
+		_stream->flush();
+		delete _stream;
+	}
+
+	inline uint64_t MemoryOStream::_write(void* handle, const uint8_t* data, uint64_t size)
+	{
+		std::vector<uint8_t>& buffer = *reinterpret_cast<MemoryOStream*>(handle)->_buffer;
+		buffer.insert(buffer.end(), data, data + size);
+
+		return size;
+	}
+
+	inline FileIStream::FileIStream(const std::filesystem::path& path, FileBackend backend) :
+		_status(),
+		_backend(backend),
+		_file(nullptr),
+		_descriptor(-1),
+		_buffer(nullptr),
+		_bufferPos(0),
+		_bufferEnd(0),
+		_endOfFile(false),
+		_stream(nullptr)
+	{
+#ifndef DJV_POSIX
+		_backend = FileBackend::Stdio;
+#endif
+
+		if (_backend == FileBackend::Stdio)
+		{
+			_file = std::fopen(path.string().c_str(), "rb");
+			RUC_CHECK(_status, RUC_VOID, _file, std::format("Could not open file '{}' for reading.", path.string()));
+
+			std::setvbuf(_file, nullptr, _IOFBF, _bufferSize);
+			_stream = new dsk::IStream(_file, _djv::read, _djv::eof);
+
+			return;
+		}
+
+#ifdef DJV_POSIX
+		int flags = O_RDONLY;
+#ifdef O_DIRECT
+		if (_backend == FileBackend::Direct)
+		{
+			flags |= O_DIRECT;
+		}
+#endif
+
+		_descriptor = ::open(path.c_str(), flags);
+		if (_descriptor == -1 && flags != O_RDONLY)
+		{
+			_descriptor = ::open(path.c_str(), O_RDONLY);	// Some file systems do not support O_DIRECT
+		}
+		RUC_CHECK(_status, RUC_VOID, _descriptor != -1, std::format("Could not open file '{}' for reading.", path.string()));
+
+#ifdef POSIX_FADV_SEQUENTIAL
+		posix_fadvise(_descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+		_buffer = new (std::align_val_t(_alignment)) uint8_t[_bufferSize];
+		_stream = new dsk::IStream(this, &FileIStream::_read, &FileIStream::_eof);
+#endif
+	}
+
+	inline dsk::IStream* FileIStream::getStream()
+	{
+		return _stream;
+	}
+
+	inline const ruc::Status& FileIStream::getStatus() const
+	{
+		return _status;
+	}
+
+	inline FileIStream::~FileIStream()
+	{
+		if (_stream)
+		{
+			delete _stream;
+		}
+
+		if (_file)
+		{
+			std::fclose(_file);
+		}
+
+#ifdef DJV_POSIX
+		if (_descriptor != -1)
+		{
+			::close(_descriptor);
+		}
+#endif
+
+		if (_buffer)
+		{
+			::operator delete[](_buffer, std::align_val_t(_alignment));
+		}
+	}
+
+	inline uint64_t FileIStream::_read(void* handle, uint8_t* data, uint64_t size)
+	{
+		FileIStream* stream = reinterpret_cast<FileIStream*>(handle);
+
+		uint64_t count = 0;
+		while (count != size && (stream->_bufferPos != stream->_bufferEnd || stream->_refill()))
+		{
+			const uint64_t n = std::min(size - count, stream->_bufferEnd - stream->_bufferPos);
+			std::copy_n(stream->_buffer + stream->_bufferPos, n, data + count);
+			stream->_bufferPos += n;
+			count += n;
+		}
+
+		return count;
+	}
+
+	inline bool FileIStream::_eof(void* handle)
+	{
+		// The buffer is refilled so that the end of the file is reported as soon as the last byte has been read
+
+		FileIStream* stream = reinterpret_cast<FileIStream*>(handle);
+		return stream->_bufferPos == stream->_bufferEnd && !stream->_refill();
+	}
+
+	inline bool FileIStream::_refill()
+	{
+		if (_endOfFile)
+		{
+			return false;
+		}
+
+#ifdef DJV_POSIX
+		// Whole buffers are read so that the file offset stays aligned for O_DIRECT
+
+		ssize_t n;
+		do
+		{
+			n = ::read(_descriptor, _buffer, _bufferSize);
+		} while (n == -1 && errno == EINTR);
+
+		_bufferPos = 0;
+		_bufferEnd = (n == -1) ? 0 : n;
+		_endOfFile = (n <= 0);
+
+		RUC_CHECK(_status, false, n != -1, "Could not read file.");
+#endif
+
+		return _bufferEnd != 0;
+	}
+
+	inline FileOStream::FileOStream(const std::filesystem::path& path, FileBackend backend) :
+		_status(),
+		_backend(backend),
+		_file(nullptr),
+		_descriptor(-1),
+		_buffer(nullptr),
+		_bufferEnd(0),
+		_fileOffset(0),
+		_stream(nullptr)
+	{
+#ifndef DJV_POSIX
+		_backend = FileBackend::Stdio;
+#endif
+
+		if (_backend == FileBackend::Stdio)
+		{
+			_file = std::fopen(path.string().c_str(), "wb");
+			RUC_CHECK(_status, RUC_VOID, _file, std::format("Could not open file '{}' for writing.", path.string()));
+
+			std::setvbuf(_file, nullptr, _IOFBF, _bufferSize);
+			_stream = new dsk::OStream(_file, _djv::write);
+
+			return;
+		}
+
+#ifdef DJV_POSIX
+		int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+		if (_backend == FileBackend::Direct)
+		{
+			flags |= O_DIRECT;
+		}
+#endif
+
+		_descriptor = ::open(path.c_str(), flags, 0666);
+		if (_descriptor == -1 && flags != (O_WRONLY | O_CREAT | O_TRUNC))
+		{
+			_descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);	// Some file systems do not support O_DIRECT
+		}
+		RUC_CHECK(_status, RUC_VOID, _descriptor != -1, std::format("Could not open file '{}' for writing.", path.string()));
+
+		_buffer = new (std::align_val_t(_alignment)) uint8_t[_bufferSize];
+		_stream = new dsk::OStream(this, &FileOStream::_write);
+#endif
+	}
+
+	inline dsk::OStream* FileOStream::getStream()
+	{
+		return _stream;
+	}
+
+	inline void FileOStream::close()
+	{
+		if (_stream)
+		{
+			_stream->flush();
+		}
+
+		if (_file)
+		{
+			const int result = std::fclose(_file);
+			_file = nullptr;
+
+			RUC_CHECK(_status, RUC_VOID, result == 0, "Could not write file.");
+		}
+
+#ifdef DJV_POSIX
+		if (_descriptor != -1)
+		{
+			// The last block is generally not a multiple of the alignment, which O_DIRECT does not allow
+
+			if (_bufferEnd != 0)
+			{
+#ifdef O_DIRECT
+				if (_backend == FileBackend::Direct)
+				{
+					fcntl(_descriptor, F_SETFL, fcntl(_descriptor, F_GETFL) & ~O_DIRECT);
+				}
+#endif
+
+				_writeBuffer(_buffer, _bufferEnd);
+				_bufferEnd = 0;
+			}
+
+			const int result = ::close(_descriptor);
+			_descriptor = -1;
+
+			RUC_CHECK(_status, RUC_VOID, result == 0, "Could not write file.");
+		}
+#endif
+	}
+
+	inline const ruc::Status& FileOStream::getStatus() const
+	{
+		return _status;
+	}
+
+	inline FileOStream::~FileOStream()
+	{
+		close();
+
+		if (_stream)
+		{
+			delete _stream;
+		}
+
+		if (_buffer)
+		{
+			::operator delete[](_buffer, std::align_val_t(_alignment));
+		}
+	}
+
+	inline uint64_t FileOStream::_write(void* handle, const uint8_t* data, uint64_t size)
+	{
+		FileOStream* stream = reinterpret_cast<FileOStream*>(handle);
+
+		uint64_t count = 0;
+		while (count != size)
+		{
+			const uint64_t n = std::min(size - count, _bufferSize - stream->_bufferEnd);
+			std::copy_n(data + count, n, stream->_buffer + stream->_bufferEnd);
+			stream->_bufferEnd += n;
+			count += n;
+
+			if (stream->_bufferEnd == _bufferSize)
+			{
+				if (!stream->_writeBuffer(stream->_buffer, _bufferSize))
+				{
+					return 0;
+				}
+
+				stream->_bufferEnd = 0;
+			}
+		}
+
+		return count;
+	}
+
+	inline bool FileOStream::_writeBuffer(const uint8_t* data, uint64_t size)
+	{
+#ifdef DJV_POSIX
+		while (size != 0)
+		{
+			const ssize_t n = ::pwrite(_descriptor, data, size, _fileOffset);
+			if (n == -1 && errno == EINTR)
+			{
+				continue;
+			}
+
+			RUC_CHECK(_status, false, n > 0, "Could not write file.");
+
+			data += n;
+			size -= n;
+			_fileOffset += n;
+		}
+#endif
+
+		return true;
+	}
+}
@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! \file
+//! \author Plgrin Marius
+//! \copyright The MIT License (MIT)
+//! \date 2020-2023
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <DejaVu/Core/CoreDecl.hpp>
+
+namespace djv
+{
+	namespace _djv
+	{
+		constexpr std::array<int32_t, 6> yuvCoefficients(double kr, double kb, bool fullRange)
+		{
+			const double kg = 1.0 - kr - kb;
+			const double yScale = fullRange ? 1.0 : 255.0 / 219.0;
+			const double cScale = fullRange ? 1.0 : 255.0 / 224.0;
+			const auto fixed = [](double x) { return static_cast<int32_t>(x * (1 << 14) + (x < 0.0 ? -0.5 : 0.5)); };
+
+			return {
+				fullRange ? 0 : 16,						// Luma offset
+				fixed(yScale),							// Luma scale
+				fixed(2.0 * (1.0 - kr) * cScale),		// Cr to red
+				fixed(2.0 * kb * (1.0 - kb) / kg * cScale),	// Cb to green
+				fixed(2.0 * kr * (1.0 - kr) / kg * cScale),	// Cr to green
+				fixed(2.0 * (1.0 - kb) * cScale)		// Cb to blue
+			};
+		}
+
+		constexpr std::array<int32_t, 6> yuvToRgbCoefficients[2][2] = {	// [ColorMatrix][fullRange], 14 bits fixed point
+			{ yuvCoefficients(0.299, 0.114, false), yuvCoefficients(0.299, 0.114, true) },
+			{ yuvCoefficients(0.2126, 0.0722, false), yuvCoefficients(0.2126, 0.0722, true) }
+		};
+	}
+
+	namespace fmt
+	{
+		inline Y4mIStream::Y4mIStream(dsk::IStream* stream) :
+			_stream(stream),
+			_status(),
+			_header{ 0, 0, y4m::ChromaFormat::Yuv420, false, 0, 1 },
+			_raw(false),
+			_chromaShiftX(0),
+			_chromaShiftY(0),
+			_planes()
+		{
+			assert(stream);
+		}
+
+		inline void Y4mIStream::readHeader(y4m::Header& header)
+		{
+			std::string token;
+			uint8_t separator;
+
+			if (!_readToken(token, separator))
+			{
+				return;
+			}
+			RUC_CHECK(_status, RUC_VOID, token == "YUV4MPEG2", "Invalid Y4M signature.");
+
+			_header = { 0, 0, y4m::ChromaFormat::Yuv420, false, 0, 1 };
+
+			while (separator != '\n')
+			{
+				if (!_readToken(token, separator))
+				{
+					return;
+				}
+
+				if (token.empty())
+				{
+					continue;
+				}
+
+				switch (token[0])
+				{
+					case 'W':
+					{
+						_header.width = std::strtoul(token.c_str() + 1, nullptr, 10);
+						break;
+					}
+					case 'H':
+					{
+						_header.height = std::strtoul(token.c_str() + 1, nullptr, 10);
+						break;
+					}
+					case 'F':
+					{
+						char* end;
+						_header.frameRateNumerator = std::strtoul(token.c_str() + 1, &end, 10);
+						_header.frameRateDenominator = (*end == ':') ? std::strtoul(end + 1, nullptr, 10) : 1;
+						break;
+					}
+					case 'C':
+					{
+						const std::string chroma = token.substr(1);
+						if (chroma == "420" || chroma == "420jpeg" || chroma == "420paldv" || chroma == "420mpeg2")
+						{
+							_header.chromaFormat = y4m::ChromaFormat::Yuv420;
+						}
+						else if (chroma == "422")
+						{
+							_header.chromaFormat = y4m::ChromaFormat::Yuv422;
+						}
+						else if (chroma == "444")
+						{
+							_header.chromaFormat = y4m::ChromaFormat::Yuv444;
+						}
+						else if (chroma == "mono")
+						{
+							_header.chromaFormat = y4m::ChromaFormat::Mono;
+						}
+						else
+						{
+							RUC_CHECK(_status, RUC_VOID, false, std::format("Unsupported Y4M colorspace '{}'.", chroma));
+						}
+						break;
+					}
+					case 'X':
+					{
+						if (token == "XCOLORRANGE=FULL")
+						{
+							_header.fullRange = true;
+						}
+						break;
+					}
+					default:
+					{
+						break;
+					}
+				}
+			}
+
+			RUC_CHECK(_status, RUC_VOID, _header.width != 0 && _header.height != 0, "Invalid Y4M frame size.");
+
+			_raw = false;
+			_setupPlanes();
+
+			header = _header;
+		}
+
+		inline void Y4mIStream::setHeader(const y4m::Header& header)
+		{
+			assert(header.width != 0);
+			assert(header.height != 0);
+
+			_header = header;
+			_raw = true;
+			_setupPlanes();
+		}
+
+		inline bool Y4mIStream::readFrame()
+		{
+			return readFrame(_planes[0].data(), _planes[1].data(), _planes[2].data());
+		}
+
+		inline bool Y4mIStream::readFrame(uint8_t* y, uint8_t* u, uint8_t* v)
+		{
+			assert(y);
+			assert(getPlaneCount() == 1 || (u && v));
+
+			if (!_status || _stream->eof())
+			{
+				return false;
+			}
+
+			if (!_raw && !_readFrameHeader())
+			{
+				return false;
+			}
+
+			// Planes are read straight into their destination
+
+			uint8_t* planes[3] = { y, u, v };
+			for (uint8_t i = 0; i < getPlaneCount(); ++i)
+			{
+				_stream->read(planes[i], static_cast<uint64_t>(getPlaneWidth(i)) * getPlaneHeight(i));
+				RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+			}
+
+			return true;
+		}
+
+		inline const y4m::Header& Y4mIStream::getHeader() const
+		{
+			return _header;
+		}
+
+		inline const uint8_t* Y4mIStream::getPlane(uint8_t index) const
+		{
+			assert(index < getPlaneCount());
+			return _planes[index].data();
+		}
+
+		inline uint32_t Y4mIStream::getPlaneWidth(uint8_t index) const
+		{
+			assert(index < 3);
+			return (index == 0) ? _header.width : ((_header.width + (1 << _chromaShiftX) - 1) >> _chromaShiftX);
+		}
+
+		inline uint32_t Y4mIStream::getPlaneHeight(uint8_t index) const
+		{
+			assert(index < 3);
+			return (index == 0) ? _header.height : ((_header.height + (1 << _chromaShiftY) - 1) >> _chromaShiftY);
+		}
+
+		inline uint8_t Y4mIStream::getPlaneCount() const
+		{
+			return (_header.chromaFormat == y4m::ChromaFormat::Mono) ? 1 : 3;
+		}
+
+		inline const ruc::Status& Y4mIStream::getStatus() const
+		{
+			return _status;
+		}
+
+		inline bool Y4mIStream::_readToken(std::string& token, uint8_t& separator)
+		{
+			token.clear();
+
+			while (true)
+			{
+				_stream->read(&separator, 1);
+				RUC_RELAYCOPY(_stream->getStatus(), _status, false);
+
+				if (separator == ' ' || separator == '\n')
+				{
+					return true;
+				}
+
+				RUC_CHECK(_status, false, token.size() < 256, "Y4M header line is too long.");
+				token.push_back(static_cast<char>(separator));
+			}
+		}
+
+		inline bool Y4mIStream::_readFrameHeader()
+		{
+			std::string token;
+			uint8_t separator;
+
+			if (!_readToken(token, separator))
+			{
+				return false;
+			}
+			RUC_CHECK(_status, false, token == "FRAME", "Expected Y4M FRAME marker.");
+
+			// Frame parameters are ignored
+
+			while (separator != '\n')
+			{
+				if (!_readToken(token, separator))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		inline void Y4mIStream::_setupPlanes()
+		{
+			switch (_header.chromaFormat)
+			{
+				case y4m::ChromaFormat::Yuv420:
+				{
+					_chromaShiftX = 1;
+					_chromaShiftY = 1;
+					break;
+				}
+				case y4m::ChromaFormat::Yuv422:
+				{
+					_chromaShiftX = 1;
+					_chromaShiftY = 0;
+					break;
+				}
+				default:
+				{
+					_chromaShiftX = 0;
+					_chromaShiftY = 0;
+					break;
+				}
+			}
+
+			for (uint8_t i = 0; i < 3; ++i)
+			{
+				_planes[i].resize((i < getPlaneCount()) ? static_cast<uint64_t>(getPlaneWidth(i)) * getPlaneHeight(i) : 0);
+			}
+		}
+	}
+}